@@ -1,5 +1,4 @@
 #include <UWB-MaUWB-AT.h>
-#include <math.h> // For sqrt function in the example
 
 // Create TAG instance
 UWBTAG myTag;
@@ -42,29 +41,24 @@ void loop() {
     
     /* Example: Using x,y position to control an LED on pin 5
      * -----------------------------------------------------
-     * // Define the area of interest (a specific zone in your space)
-     * const float zoneX = 200; // center X of zone in cm
-     * const float zoneY = 300; // center Y of zone in cm
-     * const float zoneRadius = 100; // radius of zone in cm
+     * Zones are evaluated by the library whenever a new position is
+     * calculated, so there is nothing to check here in loop().
      * 
-     * // Calculate distance from tag to zone center
-     * float dx = myTag.positionX - zoneX;
-     * float dy = myTag.positionY - zoneY;
-     * float distanceToZone = sqrt(dx*dx + dy*dy);
+     * // In setup(): define the area of interest (a specific zone in your space)
+     * pinMode(5, OUTPUT);
+     * myTag.zoneHysteresis(10);                 // 10cm band to avoid flicker at the edge
+     * int zone = myTag.addCircleZone(200, 300, 100); // center X, center Y, radius in cm
+     * myTag.onZoneEnter(onEnter);
+     * myTag.onZoneExit(onExit);
      * 
-     * // Set up LED pin if not already done in setup()
-     * // pinMode(5, OUTPUT);
+     * // Outside setup()/loop(): turn LED on when tag is inside the zone, off when outside
+     * void onEnter(int tagID, int zoneID) { digitalWrite(5, HIGH); }
+     * void onExit(int tagID, int zoneID)  { digitalWrite(5, LOW); }
      * 
-     * // Turn LED on when tag is inside the zone, off when outside
-     * if(distanceToZone < zoneRadius) {
-     *   digitalWrite(5, HIGH); // Turn LED on
-     * } else {
-     *   digitalWrite(5, LOW);  // Turn LED off
-     * }
-     * 
-     * // Alternative: Brightness based on distance (requires analogWrite)
-     * // int brightness = map(constrain(distanceToZone, 0, zoneRadius), 0, zoneRadius, 255, 0);
-     * // analogWrite(5, brightness); // LED gets brighter as tag gets closer to zone center
+     * // Rectangles and polygons (up to 8 vertices) work the same way:
+     * // myTag.addRectZone(0, 0, 190, 300);
+     * // float xs[] = {0, 380, 190}; float ys[] = {0, 0, 600};
+     * // myTag.addPolygonZone(xs, ys, 3);
      */
 
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef UWB_WORK_STEALING_POOL_H
+#define UWB_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing thread pool for the host tools.
+// Each worker owns a deque: it pops its own jobs from the back and, when
+// empty, steals from the front of the other workers' deques. Uneven jobs
+// (a chatty tag next to a quiet one) therefore spread across all cores.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int threads) {
+        if (threads < 1) threads = 1;
+        _queued = 0;
+        _pending = 0;
+        _next = 0;
+        _steals = 0;
+        _stop = false;
+
+        for (int i = 0; i < threads; i++) {
+            _workers.emplace_back(new Worker());
+        }
+        for (int i = 0; i < threads; i++) {
+            _threads.emplace_back(&WorkStealingPool::run, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(_sleepLock);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (size_t i = 0; i < _threads.size(); i++) {
+            _threads[i].join();
+        }
+    }
+
+    // Queue a job (round-robin across workers)
+    void submit(std::function<void()> job) {
+        _pending++;
+        Worker& worker = *_workers[_next++ % _workers.size()];
+        {
+            std::lock_guard<std::mutex> lock(worker.lock);
+            worker.jobs.push_back(std::move(job));
+        }
+        {
+            std::lock_guard<std::mutex> lock(_sleepLock);
+            _queued++;
+        }
+        _wake.notify_one();
+    }
+
+    // Block until every submitted job has finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(_sleepLock);
+        _done.wait(lock, [this] { return _pending.load() == 0; });
+    }
+
+    int size() const { return (int)_workers.size(); }
+    uint64_t steals() const { return _steals.load(); }
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    bool popLocal(int index, std::function<void()>& job) {
+        Worker& worker = *_workers[index];
+        std::lock_guard<std::mutex> lock(worker.lock);
+        if (worker.jobs.empty()) return false;
+        job = std::move(worker.jobs.back());
+        worker.jobs.pop_back();
+        return true;
+    }
+
+    bool steal(int index, std::function<void()>& job) {
+        int count = (int)_workers.size();
+        for (int i = 1; i < count; i++) {
+            Worker& victim = *_workers[(index + i) % count];
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                _steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(int index) {
+        std::function<void()> job;
+        while (true) {
+            if (popLocal(index, job) || steal(index, job)) {
+                _queued--;
+                job();
+                job = nullptr;
+                if (--_pending == 0) {
+                    std::lock_guard<std::mutex> lock(_sleepLock);
+                    _done.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepLock);
+            _wake.wait(lock, [this] { return _queued.load() > 0 || _stop; });
+            if (_stop && _queued.load() == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _threads;
+    std::mutex _sleepLock;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    std::atomic<int> _queued;    // Jobs sitting in deques
+    std::atomic<int> _pending;   // Jobs submitted but not finished
+    std::atomic<unsigned> _next;
+    std::atomic<uint64_t> _steals;
+    bool _stop;
+};
+
+#endif
@@ -0,0 +1,4 @@
+#ifndef UWB_HOST_ADAFRUIT_GFX_H
+#define UWB_HOST_ADAFRUIT_GFX_H
+#include <Arduino.h>
+#endif
@@ -0,0 +1,251 @@
+// Host implementation of the Arduino core subset declared in Arduino.h
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#include <chrono>
+
+HardwareSerial Serial;
+HardwareSerial Serial2;
+TwoWire Wire;
+
+// ---- Virtual clock ----
+
+static uint64_t s_time = 0;
+static float s_cpuScale = 1.0f;
+static bool s_busy = false;
+static bool s_idleAdvance = false;
+static uint64_t s_stall = 0;
+static int64_t s_clockOffset = 0;   // us
+static double s_clockDrift = 0.0;   // Fraction
+static std::chrono::steady_clock::time_point s_busyStart;
+
+static uint64_t busyElapsed() {
+    if (!s_busy) return 0;
+    std::chrono::nanoseconds host = std::chrono::steady_clock::now() - s_busyStart;
+    return (uint64_t)(host.count() / 1000.0 * s_cpuScale) + s_stall;
+}
+
+void hostSetTime(uint64_t us) { s_time = us; }
+uint64_t hostTime() { return s_time; }
+void hostSetCpuScale(float scale) { s_cpuScale = scale; }
+void hostSetIdleAdvance(bool on) { s_idleAdvance = on; }
+
+void hostSetClock(long offsetMs, float driftPpm) {
+    s_clockOffset = (int64_t)offsetMs * 1000;
+    s_clockDrift = driftPpm * 1e-6;
+}
+
+uint64_t hostMicros() { return s_time + busyElapsed(); }
+
+// The running device's reading of the virtual time
+static uint64_t localTime() {
+    uint64_t t = hostMicros();
+    return t + (int64_t)(t * s_clockDrift) + s_clockOffset;
+}
+
+void hostBeginBusy() {
+    s_busy = true;
+    s_stall = 0;
+    s_busyStart = std::chrono::steady_clock::now();
+}
+
+uint64_t hostEndBusy() {
+    uint64_t spent = busyElapsed();
+    s_busy = false;
+    return spent;
+}
+
+void hostStall(uint64_t us) {
+    if (s_busy) s_stall += us;
+}
+
+unsigned long micros() { return (unsigned long)localTime(); }
+unsigned long millis() { return (unsigned long)(localTime() / 1000); }
+
+void delay(unsigned long ms) {
+    if (s_busy) {
+        s_stall += (uint64_t)ms * 1000;
+    } else {
+        s_time += (uint64_t)ms * 1000;
+    }
+}
+
+void pinMode(int pin, int mode) { (void)pin; (void)mode; }
+void digitalWrite(int pin, int value) { (void)pin; (void)value; }
+
+// ---- String ----
+
+String::String(const char* s) : _buf(nullptr), _len(0), _cap(0) { assign(s, strlen(s)); }
+String::String(const String& other) : _buf(nullptr), _len(0), _cap(0) { assign(other._buf, other._len); }
+String::String(char c) : _buf(nullptr), _len(0), _cap(0) { assign(&c, 1); }
+
+String::String(int value, unsigned char base) : String((long)value, base) {}
+String::String(unsigned int value, unsigned char base) : String((unsigned long)value, base) {}
+
+String::String(long value, unsigned char base) : _buf(nullptr), _len(0), _cap(0) {
+    if (value < 0 && base == 10) {
+        String digits((unsigned long)-value, base);
+        assign("-", 1);
+        append(digits._buf, digits._len);
+    } else {
+        String digits((unsigned long)value, base);
+        assign(digits._buf, digits._len);
+    }
+}
+
+String::String(unsigned long value, unsigned char base) : _buf(nullptr), _len(0), _cap(0) {
+    char digits[65];
+    int n = 64;
+    digits[n] = '\0';
+    if (base < 2 || base > 16) base = 10;
+    do {
+        digits[--n] = "0123456789ABCDEF"[value % base];
+        value /= base;
+    } while (value > 0);
+    assign(digits + n, 64 - n);
+}
+
+String::String(float value, unsigned char decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned char decimals) : _buf(nullptr), _len(0), _cap(0) {
+    char text[64];
+    int n = snprintf(text, sizeof(text), "%.*f", decimals, value);
+    assign(text, n);
+}
+
+String::~String() { free(_buf); }
+
+String& String::operator=(const String& other) {
+    if (this != &other) assign(other._buf, other._len);
+    return *this;
+}
+
+String& String::operator=(const char* s) { assign(s, strlen(s)); return *this; }
+String& String::operator+=(const String& other) { append(other._buf, other._len); return *this; }
+String& String::operator+=(const char* s) { append(s, strlen(s)); return *this; }
+String& String::operator+=(char c) { append(&c, 1); return *this; }
+
+String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+
+bool String::operator==(const String& other) const {
+    return _len == other._len && memcmp(_buf, other._buf, _len) == 0;
+}
+
+bool String::operator==(const char* s) const { return strcmp(_buf, s) == 0; }
+char String::operator[](unsigned int index) const { return charAt(index); }
+
+bool String::reserve(unsigned int size) {
+    if (size + 1 <= _cap) return true;
+    char* grown = (char*)realloc(_buf, size + 1);
+    if (grown == nullptr) return false;
+    if (_buf == nullptr) grown[0] = '\0';
+    _buf = grown;
+    _cap = size + 1;
+    return true;
+}
+
+char String::charAt(unsigned int index) const { return index < _len ? _buf[index] : '\0'; }
+
+int String::indexOf(char c, unsigned int from) const {
+    if (from >= _len) return -1;
+    const char* p = (const char*)memchr(_buf + from, c, _len - from);
+    return p ? (int)(p - _buf) : -1;
+}
+
+int String::indexOf(const char* s, unsigned int from) const {
+    if (from > _len) return -1;
+    const char* p = strstr(_buf + from, s);
+    return p ? (int)(p - _buf) : -1;
+}
+
+int String::indexOf(const String& s, unsigned int from) const { return indexOf(s._buf, from); }
+
+String String::substring(unsigned int from) const { return substring(from, _len); }
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) { unsigned int t = from; from = to; to = t; }
+    if (to > _len) to = _len;
+    String r;
+    if (from < to) r.assign(_buf + from, to - from);
+    return r;
+}
+
+bool String::startsWith(const char* prefix) const {
+    size_t n = strlen(prefix);
+    return n <= _len && memcmp(_buf, prefix, n) == 0;
+}
+
+bool String::startsWith(const String& prefix) const { return startsWith(prefix._buf); }
+long String::toInt() const { return strtol(_buf, nullptr, 10); }
+float String::toFloat() const { return strtof(_buf, nullptr); }
+
+void String::assign(const char* s, unsigned int n) {
+    _len = 0;
+    if (!reserve(n)) return;
+    memmove(_buf, s, n);
+    _len = n;
+    _buf[_len] = '\0';
+}
+
+void String::append(const char* s, unsigned int n) {
+    if (_len + n + 1 > _cap && !reserve((_len + n) * 3 / 2 + 8)) return;
+    memmove(_buf + _len, s, n);
+    _len += n;
+    _buf[_len] = '\0';
+}
+
+// ---- Print ----
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) n++;
+    return n;
+}
+
+size_t Print::print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+size_t Print::print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+size_t Print::print(const __FlashStringHelper* s) { return print((const char*)s); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(int value, int base) { return print(String((long)value, (unsigned char)base)); }
+size_t Print::print(unsigned int value, int base) { return print(String((unsigned long)value, (unsigned char)base)); }
+size_t Print::print(long value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(unsigned long value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(double value, int digits) { return print(String(value, (unsigned char)digits)); }
+size_t Print::println() { return print("\r\n"); }
+
+size_t Print::printf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t*)text, (size_t)n < sizeof(text) ? n : sizeof(text) - 1);
+}
+
+// ---- HardwareSerial ----
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int rxPin, int txPin) {
+    (void)baud; (void)config; (void)rxPin; (void)txPin;
+}
+
+int HardwareSerial::available() {
+    int n = _port ? _port->available() : 0;
+    if (n == 0 && s_idleAdvance) s_time += 1000;
+    return n;
+}
+
+int HardwareSerial::read() { return _port ? _port->read() : -1; }
+int HardwareSerial::peek() { return _port ? _port->peek() : -1; }
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    return _port ? _port->write(buffer, size) : size;
+}
+
+int HardwareSerial::availableForWrite() {
+    return _port ? _port->availableForWrite() : 0x7fffffff;
+}
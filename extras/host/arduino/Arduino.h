@@ -0,0 +1,162 @@
+// Minimal Arduino core for host builds of the UWB-MaUWB-AT library
+// (uwb_loadgen). Only what the library uses is provided. Time is virtual
+// and the serial ports are backed by simulated devices, see the host hooks
+// at the end of this file.
+#ifndef UWB_HOST_ARDUINO_H
+#define UWB_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define INPUT 0
+#define SERIAL_8N1 0x800001c
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+
+class String {
+public:
+    String(const char* s = "");
+    String(const String& other);
+    String(char c);
+    String(int value, unsigned char base = 10);
+    String(unsigned int value, unsigned char base = 10);
+    String(long value, unsigned char base = 10);
+    String(unsigned long value, unsigned char base = 10);
+    String(float value, unsigned char decimals = 2);
+    String(double value, unsigned char decimals = 2);
+    ~String();
+
+    String& operator=(const String& other);
+    String& operator=(const char* s);
+    String& operator+=(const String& other);
+    String& operator+=(const char* s);
+    String& operator+=(char c);
+    friend String operator+(const String& a, const String& b);
+    friend String operator+(const String& a, const char* b);
+    friend String operator+(const char* a, const String& b);
+    bool operator==(const String& other) const;
+    bool operator==(const char* s) const;
+    char operator[](unsigned int index) const;
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return _len; }
+    const char* c_str() const { return _buf; }
+    char charAt(unsigned int index) const;
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const char* s, unsigned int from = 0) const;
+    int indexOf(const String& s, unsigned int from = 0) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    bool startsWith(const char* prefix) const;
+    bool startsWith(const String& prefix) const;
+    long toInt() const;
+    float toFloat() const;
+
+private:
+    void assign(const char* s, unsigned int n);
+    void append(const char* s, unsigned int n);
+    char* _buf;
+    unsigned int _len;
+    unsigned int _cap;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    virtual int availableForWrite() { return 0x7fffffff; }
+    size_t print(const char* s);
+    size_t print(const String& s);
+    size_t print(const __FlashStringHelper* s);
+    size_t print(char c);
+    size_t print(int value, int base = 10);
+    size_t print(unsigned int value, int base = 10);
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(double value, int digits = 2);
+    size_t println();
+    template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(const T& value, int arg) { size_t n = print(value, arg); return n + println(); }
+    size_t printf(const char* format, ...);
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+class HostSerialPort;
+
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial() : _port(nullptr) {}
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int rxPin = -1, int txPin = -1);
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int availableForWrite() override;
+    using Print::write;
+
+    // Host: route this port to a simulated device (nullptr = disconnected)
+    void setPort(HostSerialPort* port) { _port = port; }
+    HostSerialPort* getPort() const { return _port; }
+
+private:
+    HostSerialPort* _port;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+// ---- Host hooks (not part of the Arduino API) ----
+
+// Backend of a HardwareSerial. A port without one discards writes and
+// never has data available.
+class HostSerialPort {
+public:
+    virtual ~HostSerialPort() {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) = 0;
+    virtual int availableForWrite() { return 0x7fffffff; }
+};
+
+// Virtual clock in microseconds. Outside a busy section millis()/micros()
+// return it and delay() advances it. Inside one (the simulated device is
+// running code) they also count the host CPU time since hostBeginBusy()
+// multiplied by the CPU scale, plus any stalls, so the code under test
+// sees roughly the time it would take on the target.
+void hostSetTime(uint64_t us);
+uint64_t hostTime();
+void hostSetCpuScale(float scale);       // Target time per host time (default 1)
+void hostBeginBusy();
+uint64_t hostEndBusy();                  // Target us spent since hostBeginBusy()
+void hostStall(uint64_t us);             // Blocked inside a busy section (e.g. full TX FIFO)
+void hostSetIdleAdvance(bool on);        // Polling an empty port advances the clock 1 ms,
+                                         // so setup busy-waits on millis() terminate
+void hostSetClock(long offsetMs, float driftPpm); // Clock of the device about to run: millis()/micros()
+                                         // read virtual time × (1 + drift) + offset (default 0, 0)
+uint64_t hostMicros();                   // Virtual time with the busy section, for simulated hardware
+
+#endif
@@ -0,0 +1,233 @@
+// Steady-state allocation check: a Position Server ingesting range
+// reports, fix uploads and sync requests, and a tag ranging, uploading,
+// syncing and reading ALLPOS frames, must not touch the heap inside any
+// scheduled task once warmed up. Built like uwb_loadgen with the
+// allocator wrappers (UWBMemory.h); the test's own port uses fixed
+// buffers so only the library's allocations are counted.
+
+#include "uwb_test.h"
+#include <Arduino.h>
+#include <UWB-MaUWB-AT.h>
+#include <UWBMemory.h>
+#include <UWBProtocol.h>
+
+#include <cstring>
+
+// Module side of Serial2: lines queued for the host, and the last
+// AT+DATA payload the host sent
+class LinePort : public HostSerialPort {
+public:
+    LinePort() : _head(0), _count(0), _commandLength(0), _dataLength(0), commands(0) {}
+
+    void queueLine(const char* line) {
+        int length = (int)strlen(line);
+        if (_count + length + 2 > (int)sizeof(_rx)) return;
+        for (int i = 0; i < length; i++) push(line[i]);
+        push('\r');
+        push('\n');
+    }
+
+    int available() override { return _count; }
+
+    int read() override {
+        if (_count == 0) return -1;
+        char c = _rx[_head];
+        _head = (_head + 1) % (int)sizeof(_rx);
+        _count--;
+        return (uint8_t)c;
+    }
+
+    int peek() override { return _count ? (uint8_t)_rx[_head] : -1; }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        for (size_t i = 0; i < size; i++) {
+            char c = (char)buffer[i];
+            if (c == '\n') {
+                _command[_commandLength] = '\0';
+                commands++;
+                // AT+DATA=<length>,<payload>
+                const char* comma = strchr(_command, ',');
+                if (strncmp(_command, "AT+DATA=", 8) == 0 && comma != nullptr) {
+                    strcpy(_data, comma + 1);
+                    _dataLength = (int)strlen(_data);
+                }
+                _commandLength = 0;
+            } else if (c != '\r' && _commandLength < (int)sizeof(_command) - 1) {
+                _command[_commandLength++] = c;
+            }
+        }
+        return size;
+    }
+
+    // Take the last AT+DATA payload (empty if none since the last call)
+    const char* takeData() {
+        if (_dataLength == 0) return "";
+        _dataLength = 0;
+        return _data;
+    }
+
+private:
+    void push(char c) {
+        _rx[(_head + _count) % (int)sizeof(_rx)] = c;
+        _count++;
+    }
+
+    char _rx[8192];
+    int _head;
+    int _count;
+    char _command[4096];
+    int _commandLength;
+    char _data[4096];
+    int _dataLength;
+
+public:
+    uint32_t commands;
+};
+
+static const float ANCHOR_X[4] = {0, 0, 1000, 1000};
+static const float ANCHOR_Y[4] = {0, 800, 800, 0};
+
+static void rangeLine(int tagID, uint32_t seq, float x, float y, char* line, int size) {
+    int n = snprintf(line, size, "AT+RANGE=tid:%d,mask:0F,seq:%u,range:(", tagID, (unsigned)seq);
+    for (int i = 0; i < 4; i++) {
+        float range = std::hypot(x - ANCHOR_X[i], y - ANCHOR_Y[i]);
+        n += snprintf(line + n, size - n, "%s%.0f", i ? "," : "", range);
+    }
+    snprintf(line + n, size - n, ",0,0,0,0),rssi:(-70,-72,-75,-71,0,0,0,0)");
+}
+
+// Allocations charged to the scheduled tasks (setup and this test's own
+// code land in UWB_ALLOC_OTHER)
+static uint32_t taskAllocations(const char* who) {
+    uint32_t total = 0;
+    for (int task = 0; task < TASK_COUNT; task++) {
+        UWBAllocCount count;
+        uwbAllocGet(task, count);
+        if (count.allocations > 0) {
+            fprintf(stderr, "%s: task %d allocated %u times (%u bytes)\n", who, task,
+                    (unsigned)count.allocations, (unsigned)count.bytes);
+        }
+        total += count.allocations;
+    }
+    return total;
+}
+
+static const int TAGS = 4;
+static const uint64_t STEP_US = 5000;
+
+static void testServer() {
+    LinePort port;
+    Serial2.setPort(&port);
+    hostSetTime(1000000);
+    hostSetIdleAdvance(true);
+    UWBAnchor server(POSITION_SERVER);
+    server.setAnchorNumber(0);
+    server.totalTags(TAGS);
+    for (int i = 0; i < 4; i++) server.setOtherAnchor(i, ANCHOR_X[i], ANCHOR_Y[i]);
+    server.outlierRejection(30);
+    hostSetIdleAdvance(false);
+
+    char line[256];
+    uint32_t seq = 0;
+    uint64_t t = hostTime();
+    for (int round = 0; round < 2000; round++) {
+        if (round == 400) uwbAllocReset();   // Warm: tables and line buffers in use
+        t += STEP_US;
+        hostSetTime(t);
+        int tagID = round % TAGS;
+        float x = 200 + 20 * tagID + (round % 50) * 10;
+        float y = 300 + (round % 30) * 5;
+        if (tagID == 3 && round % 8 == 3) {
+            // This tag solves itself and uploads, asking for sync every other time
+            UWBFixReport fix = {};
+            fix.tagID = tagID;
+            fix.seq = seq++;
+            fix.x = x;
+            fix.y = y;
+            fix.residual = 2;
+            fix.age = 20;
+            fix.hasSent = (round % 16 == 3);
+            fix.sent = millis() - 15;
+            char payload[96];
+            int length = formatFixReport(fix, payload, sizeof(payload));
+            snprintf(line, sizeof(line), "AT+RDATA=3,0,%lu,%d,%s", millis(), length, payload);
+        } else if (tagID == 2 && round % 40 == 2) {
+            UWBSyncRequest request = {tagID, (uint32_t)millis() - 10};
+            char payload[32];
+            int length = formatSyncRequest(request, payload, sizeof(payload));
+            snprintf(line, sizeof(line), "AT+RDATA=2,0,%lu,%d,%s", millis(), length, payload);
+        } else {
+            rangeLine(tagID, seq++, x, y, line, sizeof(line));
+        }
+        port.queueLine(line);
+        server.update();
+    }
+    Serial2.setPort(nullptr);
+
+    CHECK(port.commands > 0);     // Broadcasts went out
+    CHECK(server.getTrackedTagCount() == TAGS);
+    CHECK(taskAllocations("server") == 0);
+}
+
+static void testTag() {
+    LinePort port;
+    Serial2.setPort(&port);
+    hostSetTime(1000000);
+    hostSetIdleAdvance(true);
+    UWBTAG tag;
+    tag.setTagNumber(1);
+    tag.totalTags(TAGS);
+    tag.anchor0(ANCHOR_X[0], ANCHOR_Y[0]);
+    tag.anchor1(ANCHOR_X[1], ANCHOR_Y[1]);
+    tag.anchor2(ANCHOR_X[2], ANCHOR_Y[2]);
+    tag.anchor3(ANCHOR_X[3], ANCHOR_Y[3]);
+    tag.uploadFixes(200);
+    tag.clockSync(500);
+    tag.solverIterations(5);
+    hostSetIdleAdvance(false);
+    port.takeData();
+
+    char line[512];
+    uint32_t seq = 0;
+    uint64_t t = hostTime();
+    for (int round = 0; round < 2000; round++) {
+        if (round == 400) uwbAllocReset();
+        t += STEP_US;
+        hostSetTime(t);
+        float x = 300 + (round % 50) * 10;
+        float y = 400 + (round % 30) * 5;
+        if (round % 20 == 0) {
+            rangeLine(1, seq++, x, y, line, sizeof(line));
+            port.queueLine(line);
+        }
+        if (round % 40 == 10) {
+            // Server broadcast, echoing the tag's last sync request if any
+            char frame[256];
+            int n = snprintf(frame, sizeof(frame), "ALLPOS@%lu", millis() + 5000);
+            UWBSyncRequest request;
+            const char* data = port.takeData();
+            if (parseSyncRequest(data, request) || (strncmp(data, "FIX:", 4) == 0 &&
+                                                    sscanf(data, "FIX:%*d:%*u:%*f:%*f:%*f:%*u:%u", &request.sent) == 1)) {
+                UWBSyncEcho echo = {1, request.sent, (uint32_t)millis() + 4990};
+                n += formatSyncEcho(echo, frame + n, sizeof(frame) - n);
+            }
+            snprintf(frame + n, sizeof(frame) - n, ":0:120.0:340.0:30:2:500.5:600.0:80");
+            snprintf(line, sizeof(line), "AT+RDATA=0,0,%lu,%d,%s", millis(), (int)strlen(frame), frame);
+            port.queueLine(line);
+        }
+        tag.update();
+    }
+    Serial2.setPort(nullptr);
+
+    CHECK(port.commands > 0);
+    CHECK(tag.positionX > 0 && tag.positionY > 0);
+    CHECK(tag.isClockSynced());
+    CHECK(taskAllocations("tag") == 0);
+}
+
+int main() {
+    CHECK(uwbAllocCounting());
+    testServer();
+    testTag();
+    return UWB_TEST_RESULT();
+}
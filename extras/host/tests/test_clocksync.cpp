@@ -0,0 +1,93 @@
+// UWBClockSync: offsets from symmetric round trips, the shortest round
+// trip winning over asymmetric ones, millis() wrap on either clock, and a
+// server that has been up for days with a drifting crystal.
+
+#include "uwb_test.h"
+#include <UWBClockSync.h>
+
+static void testOffset() {
+    UWBClockSync sync;
+    CHECK(!sync.isSynced());
+    CHECK(sync.toServer(1234) == 1234);
+
+    // Server 50000 ms ahead, 10 ms each way, 4 ms in the server
+    CHECK(sync.addSample(1000, 51010, 51014, 1024));
+    CHECK(sync.isSynced());
+    CHECK(sync.getDelay() == 20);
+    CHECK_NEAR(sync.getOffset(1024), 50000, 0.5);
+    CHECK(sync.toServer(2000) == 52000);
+    CHECK(sync.toLocal(52000) == 2000);
+
+    // A slower, lopsided round trip (100 ms out, 10 ms back) does not
+    // replace the short one
+    CHECK(sync.addSample(3000, 53100, 53104, 3114));
+    CHECK(sync.getDelay() == 20);
+    CHECK(sync.toServer(4000) == 54000);
+
+    // Round trips longer than MAX_DELAY are discarded
+    CHECK(!sync.addSample(5000, 55600, 55600, 6200));
+    CHECK(sync.getSamples() == 2);
+
+    sync.reset();
+    CHECK(!sync.isSynced());
+}
+
+static void testWrap() {
+    // Tag clock wraps during the round trip; server is behind the tag
+    UWBClockSync sync;
+    uint32_t t1 = 0xFFFFFFF0u;
+    uint32_t t2 = t1 - 700000 + 10;
+    uint32_t t3 = t2 + 2;
+    uint32_t t4 = t1 + 22;   // Wraps to 6
+    CHECK(t4 < t1);
+    CHECK(sync.addSample(t1, t2, t3, t4));
+    CHECK(sync.getDelay() == 20);
+    CHECK_NEAR(sync.getOffset(t4), -700000, 0.5);
+    CHECK(sync.toServer(100) == 100u - 700000u);
+    CHECK(sync.toLocal(100u - 700000u) == 100);
+
+    // Server clock wraps instead
+    UWBClockSync server;
+    t1 = 5000;
+    t2 = 0xFFFFFFFAu;
+    t3 = t2 + 12;            // Wraps to 6
+    t4 = t1 + 32;
+    CHECK(server.addSample(t1, t2, t3, t4));
+    CHECK(server.getDelay() == 20);
+    uint32_t expected = 0xFFFFFFFAu - 10;   // Received 10 ms after sending
+    CHECK(server.toServer(5000) == expected);
+    CHECK(server.toServer(6000) == expected + 1000);
+    CHECK(server.toLocal(server.toServer(123456)) == 123456);
+}
+
+static void testLongUptime() {
+    // Server up for 10 days before the tag booted, crystal 20 ppm fast.
+    // One round trip every 2 s for 20 min, 5 ms each way.
+    const double offset = 10 * 86400e3;
+    const double ppm = 20;
+    UWBClockSync sync;
+    double worst = 0;
+    for (int k = 0; k < 600; k++) {
+        double t1 = 5000 + k * 2000.0;
+        double t2 = (t1 + 5) * (1 + ppm * 1e-6) + offset;
+        double t3 = t2 + 3;
+        double t4 = t1 + 5 + 3 / (1 + ppm * 1e-6) + 5;
+        sync.addSample((uint32_t)std::llround(t1), (uint32_t)std::floor(t2),
+                       (uint32_t)std::floor(t3), (uint32_t)std::floor(t4));
+        if (k < 300) continue;
+        // Predict 0.7 s past the last round trip
+        uint32_t local = (uint32_t)std::floor(t4 + 700);
+        uint32_t server = (uint32_t)std::floor(local * (1 + ppm * 1e-6) + offset);
+        double error = std::fabs((double)(int32_t)(sync.toServer(local) - server));
+        if (error > worst) worst = error;
+    }
+    CHECK(worst <= 2);
+    CHECK_NEAR(sync.getDrift(), ppm, 2);
+}
+
+int main() {
+    testOffset();
+    testWrap();
+    testLongUptime();
+    return UWB_TEST_RESULT();
+}
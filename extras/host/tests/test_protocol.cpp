@@ -0,0 +1,122 @@
+// UWBProtocol parsers: AT+RANGE reports, FIX uploads, SYNC requests and
+// echoes, and ANCHORS lists, including the malformed lines they reject.
+
+#include "uwb_test.h"
+#include <UWBProtocol.h>
+
+static void testRangeReport() {
+    UWBRangeReport report;
+    CHECK(parseRangeReport("AT+RANGE=tid:12,mask:0B,seq:345,range:(150,220,0,310,0,0,0,0),"
+                           "rssi:(-71.5,-80,0,-90,0,0,0,0)", report));
+    CHECK(report.tagID == 12);
+    CHECK(report.hasSeq && report.seq == 345);
+    CHECK(report.hasRanges && report.hasRssi);
+    CHECK(report.mask == 0x0B);
+    CHECK_NEAR(report.range[0], 150, 0);
+    CHECK_NEAR(report.range[1], 220, 0);
+    CHECK_NEAR(report.range[2], 0, 0);
+    CHECK_NEAR(report.range[3], 310, 0);
+    CHECK_NEAR(report.rssi[0], -71.5, 0);
+    CHECK_NEAR(report.rssi[3], -90, 0);
+
+    // A mask bit with a zero range counts as missing, and clear bits are
+    // never converted
+    CHECK(parseRangeReport("AT+RANGE=tid:3,mask:07,range:(100,0,300,400)", report));
+    CHECK(report.mask == 0x05);
+    CHECK(!report.hasSeq && !report.hasRssi);
+    CHECK_NEAR(report.range[3], 0, 0);
+
+    // No mask: every non-zero range sets its bit
+    CHECK(parseRangeReport("AT+RANGE=tid:4,range:(0,120,0,0,0,0,0,99)", report));
+    CHECK(report.mask == 0x82);
+
+    // A report without ranges is still a report
+    CHECK(parseRangeReport("AT+RANGE=tid:5,mask:00,", report));
+    CHECK(!report.hasRanges && report.tagID == 5);
+
+    CHECK(!parseRangeReport("AT+RANGE=tid:5", report));      // Truncated after tid
+    CHECK(!parseRangeReport("OK", report));
+    CHECK(!parseRangeReport("XAT+RANGE=tid:1,range:(1)", report));
+}
+
+static void testFixReport() {
+    UWBFixReport fix = {};
+    fix.tagID = 7;
+    fix.seq = 4000000000u;
+    fix.x = -123.4f;
+    fix.y = 5678.9f;
+    fix.residual = -1;
+    fix.age = 35;
+    fix.hasSent = true;
+    fix.sent = 4294967295u;
+
+    char line[96];
+    int n = formatFixReport(fix, line, sizeof(line));
+    CHECK(n > 0);
+
+    UWBFixReport out;
+    CHECK(parseFixReport(line, out));
+    CHECK(out.tagID == 7 && out.seq == fix.seq && out.age == 35);
+    CHECK_NEAR(out.x, -123.4, 0.05);
+    CHECK_NEAR(out.y, 5678.9, 0.05);
+    CHECK_NEAR(out.residual, -1, 0);
+    CHECK(out.hasSent && out.sent == fix.sent);
+
+    // Without the sync stamp, and inside an AT+RDATA line
+    CHECK(parseFixReport("AT+RDATA=1,FIX:9:1:10.0:20.0:3.5:100", out));
+    CHECK(out.tagID == 9 && !out.hasSent && out.age == 100);
+
+    CHECK(formatFixReport(fix, line, 10) == 0);          // Does not fit
+    CHECK(!parseFixReport("FIX:9:1:10.0:20.0", out));    // Missing fields
+    CHECK(!parseFixReport("FIX::1:2:3:4:5", out));
+}
+
+static void testSync() {
+    UWBSyncRequest request = {21, 123456789u};
+    char line[64];
+    CHECK(formatSyncRequest(request, line, sizeof(line)) > 0);
+    UWBSyncRequest parsedRequest;
+    CHECK(parseSyncRequest(line, parsedRequest));
+    CHECK(parsedRequest.tagID == 21 && parsedRequest.sent == 123456789u);
+    CHECK(!parseSyncRequest("SYNC:21:", parsedRequest));
+    CHECK(!parseSyncRequest("SYNC:x:1", parsedRequest));
+
+    // Echoes sit in the ALLPOS header, before the first ':'
+    const char* header = "ALLPOS@5000!3,100,4990!21,4294967290,4995:3:10:20:5";
+    UWBSyncEcho echo;
+    CHECK(parseSyncEcho(header, 21, echo));
+    CHECK(echo.tagID == 21 && echo.sent == 4294967290u && echo.received == 4995);
+    CHECK(parseSyncEcho(header, 3, echo));
+    CHECK(echo.sent == 100 && echo.received == 4990);
+    CHECK(!parseSyncEcho(header, 2, echo));               // No echo for tag 2
+    CHECK(!parseSyncEcho("ALLPOS@5000:2:!2,1,2", 2, echo)); // Past the header
+
+    UWBSyncEcho in = {8, 1, 2};
+    CHECK(formatSyncEcho(in, line, sizeof(line)) > 0);
+    CHECK(parseSyncEcho(line, 8, echo) && echo.sent == 1 && echo.received == 2);
+}
+
+static void testAnchorList() {
+    UWBAnchorPosition anchors[3] = {{0, 0, 0}, {1, 1000.5f, 0}, {5, 500, -866.2f}};
+    char line[128];
+    CHECK(formatAnchorList(anchors, 3, line, sizeof(line)) > 0);
+
+    UWBAnchorPosition out[8];
+    CHECK(parseAnchorList(line, out, 8) == 3);
+    CHECK(out[2].id == 5);
+    CHECK_NEAR(out[1].x, 1000.5, 0.05);
+    CHECK_NEAR(out[2].y, -866.2, 0.05);
+
+    CHECK(parseAnchorList(line, out, 2) == 2);            // maxCount honoured
+    CHECK(parseAnchorList("ANCHORS:1:2", out, 8) == 0);   // Truncated entry
+    CHECK(formatAnchorList(anchors, 0, line, sizeof(line)) == 0);
+    CHECK(formatAnchorList(anchors, 3, line, 16) == 0);
+}
+
+int main() {
+    testRangeReport();
+    testFixReport();
+    testSync();
+    testAnchorList();
+    return UWB_TEST_RESULT();
+}
@@ -0,0 +1,174 @@
+// UWBSite: a tag walking a 16-zone corridor whose anchor IDs repeat every
+// 4 columns stays in the right zone, zone adjacency, and a lost tag's full
+// rescan being rate limited.
+
+#include "uwb_test.h"
+#include <UWBSite.h>
+
+#include <random>
+
+static const int ZONES = 16;
+static const float ZONE_LENGTH = 600;
+static const float CORRIDOR_WIDTH = 400;
+
+// Two anchors (one per wall) at every zone boundary; IDs repeat every 4 columns
+static int anchorCount = 0;
+static int anchorID[2 * (ZONES + 1)];
+static float anchorX[2 * (ZONES + 1)];
+static float anchorY[2 * (ZONES + 1)];
+
+static void buildCorridor(UWBSite& site) {
+    anchorCount = 0;
+    for (int column = 0; column <= ZONES; column++) {
+        for (int wall = 0; wall < 2; wall++) {
+            anchorID[anchorCount] = (column % 4) * 2 + wall;
+            anchorX[anchorCount] = column * ZONE_LENGTH;
+            anchorY[anchorCount] = wall * CORRIDOR_WIDTH;
+            anchorCount++;
+        }
+    }
+    for (int z = 0; z < ZONES; z++) {
+        CHECK(site.addZone(z * ZONE_LENGTH, 0, (z + 1) * ZONE_LENGTH, CORRIDOR_WIDTH) == z);
+        for (int i = 0; i < anchorCount; i++) {
+            if (anchorX[i] == z * ZONE_LENGTH || anchorX[i] == (z + 1) * ZONE_LENGTH) {
+                CHECK(site.addAnchor(z, anchorID[i], anchorX[i], anchorY[i]));
+            }
+        }
+    }
+}
+
+// Ranges as the module reports them: the nearest anchor with each ID
+// within radio range (10 m), with noise
+static uint8_t corridorRanges(float x, float y, std::mt19937& rng, float* distances) {
+    std::normal_distribution<float> noise(0, 5);
+    float nearest[8];
+    uint8_t mask = 0;
+    for (int i = 0; i < 8; i++) {
+        distances[i] = 0;
+        nearest[i] = 1e9;
+    }
+    for (int i = 0; i < anchorCount; i++) {
+        float range = std::hypot(x - anchorX[i], y - anchorY[i]);
+        int id = anchorID[i];
+        if (range < 1000 && range < nearest[id]) {
+            nearest[id] = range;
+            distances[id] = range + noise(rng);
+            mask |= (1 << id);
+        }
+    }
+    return mask;
+}
+
+static void testCorridor() {
+    UWBSite site;
+    buildCorridor(site);
+    CHECK(site.getNeighbours(0) == 0x0002);
+    CHECK(site.getNeighbours(5) == 0x0050);
+    CHECK(site.getNeighbours(15) == 0x4000);
+
+    UWBSolver solver;
+    solver.setRefinement(3, 1.0);
+    site.setActiveZone(0);
+    std::mt19937 rng(3);
+    float x = 0, y = 0;
+    bool warm = false;
+    int fixes = 0, walked = 0, changes = 0, backwards = 0;
+    double error = 0;
+    int last = 0;
+    for (float tx = 20; tx < ZONES * ZONE_LENGTH - 20; tx += 3) {
+        float ty = 200 + 100 * std::sin(tx / 200);
+        float d[8];
+        uint8_t mask = corridorRanges(tx, ty, rng, d);
+        walked++;
+        if (!site.solve(solver, d, mask, nullptr, x, y, warm)) continue;
+        fixes++;
+        warm = true;
+        error += std::hypot(x - tx, y - ty);
+        int zone = site.getActiveZone();
+        if (zone != last) {
+            changes++;
+            if (zone != last + 1) backwards++;
+            last = zone;
+        }
+        CHECK(site.residual(d, site.getActiveSet() & ~site.getRejected(), x, y) >= 0);
+    }
+    double mean = error / fixes;
+    printf("corridor: %d/%d fixes, mean error %.1f cm, %d zone changes\n", fixes, walked, mean, changes);
+    CHECK(fixes == walked);
+    CHECK(mean < 10);
+    CHECK(changes == ZONES - 1);   // One step forward per boundary, never a wrong zone
+    CHECK(backwards == 0);
+    CHECK(site.getActiveZone() == ZONES - 1);
+}
+
+// Two rooms far apart, each with its own anchor IDs
+static void buildRooms(UWBSite& site) {
+    site.addZone(0, 0, 600, 400);
+    site.addAnchor(0, 0, 0, 0);
+    site.addAnchor(0, 1, 0, 400);
+    site.addAnchor(0, 2, 600, 400);
+    site.addAnchor(0, 3, 600, 0);
+    site.addZone(5000, 0, 5600, 400);
+    site.addAnchor(1, 4, 5000, 0);
+    site.addAnchor(1, 5, 5000, 400);
+    site.addAnchor(1, 6, 5600, 400);
+    site.addAnchor(1, 7, 5600, 0);
+}
+
+static uint8_t roomRanges(float x, float y, float* distances) {
+    static const float xs[8] = {0, 0, 600, 600, 5000, 5000, 5600, 5600};
+    static const float ys[8] = {0, 400, 400, 0, 0, 400, 400, 0};
+    uint8_t mask = 0;
+    for (int i = 0; i < 8; i++) {
+        distances[i] = 0;
+        float range = std::hypot(x - xs[i], y - ys[i]);
+        if (range < 1000) {
+            distances[i] = range;
+            mask |= (1 << i);
+        }
+    }
+    return mask;
+}
+
+static void testRescan() {
+    UWBSite site;
+    buildRooms(site);
+    CHECK(site.getNeighbours(0) == 0 && site.getNeighbours(1) == 0);
+    UWBSolver solver;
+    float d[8];
+    float x = 0, y = 0;
+
+    uint8_t mask = roomRanges(300, 200, d);
+    CHECK(site.solve(solver, d, mask, nullptr, x, y, false));
+    CHECK(site.getActiveZone() == 0);
+    CHECK(site.residual(d, mask, x, y) < 1);
+
+    // Carried to the other room: not a neighbour, found by the full scan
+    mask = roomRanges(5300, 100, d);
+    CHECK(site.solve(solver, d, mask, nullptr, x, y, true));
+    CHECK(site.getActiveZone() == 1);
+    CHECK_NEAR(x, 5300, 1);
+
+    // Ranges that fit nowhere: one full scan, then RESCAN_INTERVAL solves
+    // without one, during which even good ranges for the other room fail
+    site.setActiveZone(0);
+    for (int i = 0; i < 8; i++) d[i] = 3000;
+    CHECK(!site.solve(solver, d, 0xFF, nullptr, x, y, true));
+    mask = roomRanges(5300, 100, d);
+    for (int i = 0; i < UWBSite::RESCAN_INTERVAL; i++) {
+        CHECK(!site.solve(solver, d, mask, nullptr, x, y, true));
+    }
+    CHECK(site.getActiveZone() == 0);
+    CHECK(site.solve(solver, d, mask, nullptr, x, y, true));
+    CHECK(site.getActiveZone() == 1);
+
+    site.clear();
+    CHECK(site.zoneCount() == 0 && site.getActiveZone() == -1);
+    CHECK(!site.solve(solver, d, mask, nullptr, x, y, true));
+}
+
+int main() {
+    testCorridor();
+    testRescan();
+    return UWB_TEST_RESULT();
+}
@@ -0,0 +1,125 @@
+// UWBSolver: exact ranges solve exactly, the DOP table keeps flat
+// triangles out of the fix, and with outlier rejection on a single NLOS
+// range (too long by a wall's detour) is left out of the fix.
+
+#include "uwb_test.h"
+#include <UWBSolver.h>
+
+#include <random>
+
+static const float ANCHOR_X[] = {0, 1000, 1000, 0, 500};
+static const float ANCHOR_Y[] = {0, 0, 800, 800, 1200};
+static const int ANCHORS = 5;
+
+static void ranges(float x, float y, float* distances) {
+    for (int i = 0; i < UWBSolver::MAX_ANCHORS; i++) distances[i] = 0;
+    for (int i = 0; i < ANCHORS; i++) {
+        float dx = x - ANCHOR_X[i], dy = y - ANCHOR_Y[i];
+        distances[i] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+static void layout(UWBSolver& solver) {
+    for (int i = 0; i < ANCHORS; i++) solver.setAnchor(i, ANCHOR_X[i], ANCHOR_Y[i]);
+}
+
+static void testExact() {
+    UWBSolver solver;
+    layout(solver);
+    CHECK(solver.getTriangleCount() > 0);
+    CHECK(solver.getBestDOP(0x1F) >= 1.0f);
+    CHECK(solver.getBestDOP(0x03) == 0);   // Two anchors: no triangle
+
+    float d[UWBSolver::MAX_ANCHORS];
+    ranges(400, 300, d);
+    float x, y;
+    CHECK(solver.solve(d, x, y));
+    CHECK_NEAR(x, 400, 1);
+    CHECK_NEAR(y, 300, 1);
+    CHECK_NEAR(solver.residual(d, 0x1F, x, y), 0, 1);
+
+    // Fewer than three anchors cannot be solved
+    CHECK(!solver.solve(d, 0x03, nullptr, x, y));
+}
+
+static void testOutlierRejection() {
+    const float trueX = 400, trueY = 300;
+    float d[UWBSolver::MAX_ANCHORS];
+    ranges(trueX, trueY, d);
+    d[2] += 150;   // NLOS: anchor 2 reads 1.5 m long
+
+    UWBSolver plain;
+    layout(plain);
+    plain.setRefinement(10, 0.1f);
+    float x = trueX, y = trueY;
+    uint8_t rejected = 0xFF;
+    CHECK(plain.solve(d, 0x1F, nullptr, x, y, true, &rejected));
+    CHECK(rejected == 0);
+    float plainError = std::hypot(x - trueX, y - trueY);
+    CHECK(plainError > 20);
+
+    UWBSolver solver;
+    layout(solver);
+    solver.setRefinement(10, 0.1f);
+    solver.setOutlierRejection(20);
+    x = trueX;
+    y = trueY;
+    CHECK(solver.solve(d, 0x1F, nullptr, x, y, true, &rejected));
+    CHECK(rejected == 0x04);
+    CHECK_NEAR(x, trueX, 2);
+    CHECK_NEAR(y, trueY, 2);
+
+    // Cold start (closed form first) reaches the same fix
+    x = y = 0;
+    CHECK(solver.solve(d, 0x1F, nullptr, x, y, false, &rejected));
+    CHECK(rejected == 0x04);
+    CHECK_NEAR(x, trueX, 2);
+    CHECK_NEAR(y, trueY, 2);
+
+    // Clean ranges: nothing is rejected
+    ranges(trueX, trueY, d);
+    CHECK(solver.solve(d, 0x1F, nullptr, x, y, true, &rejected));
+    CHECK(rejected == 0);
+
+    // Never below three anchors: with only three reporting the bad range stays
+    d[2] += 150;
+    CHECK(solver.solve(d, 0x07, nullptr, x, y, true, &rejected));
+    CHECK(rejected == 0);
+}
+
+static void testGeometry() {
+    // Four anchors along one wall: their triangles are flat, so the DOP
+    // table must favour the ones using the far anchors
+    const float xs[8] = {0, 333, 667, 1000, 0, 1000, 500, 1000};
+    const float ys[8] = {0, 0, 0, 0, 800, 800, 1200, 400};
+    UWBSolver solver;
+    for (int i = 0; i < 8; i++) solver.setAnchor(i, xs[i], ys[i]);
+    CHECK(solver.getBestDOP(0x0F) == 0);     // Collinear: no usable triangle
+    CHECK(solver.getBestDOP(0x31) > 0);
+    CHECK(solver.getBestDOP(0x31) < 2);      // 0, 4, 5: a broad triangle
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0, 5);
+    double error = 0;
+    int fixes = 0;
+    for (float x = 50; x < 1000; x += 50) {
+        for (float y = 50; y < 800; y += 50) {
+            float d[8];
+            for (int i = 0; i < 8; i++) d[i] = std::hypot(x - xs[i], y - ys[i]) + noise(rng);
+            float fx, fy;
+            CHECK(solver.solve(d, 0xFF, nullptr, fx, fy));
+            error += std::hypot(fx - x, fy - y);
+            fixes++;
+        }
+    }
+    double mean = error / fixes;
+    printf("wall layout: mean error %.1f cm over %d fixes\n", mean, fixes);
+    CHECK(mean < 5.5);   // About 7.5 cm averaging every triangle alike
+}
+
+int main() {
+    testExact();
+    testGeometry();
+    testOutlierRejection();
+    return UWB_TEST_RESULT();
+}
@@ -0,0 +1,142 @@
+// COBS/CRC framing: records survive a queue -> decoder round trip, zero
+// bytes in the payload are escaped, and a corrupted frame is counted and
+// skipped without losing the next one.
+
+#include "uwb_test.h"
+#include <UWBStream.h>
+
+#include <cstring>
+
+// Drain a queue into a byte buffer
+static int drain(UWBFrameQueue& queue, uint8_t* out, int size) {
+    int total = 0;
+    const uint8_t* data;
+    int count;
+    while ((count = queue.peek(&data)) > 0 && total + count <= size) {
+        memcpy(out + total, data, count);
+        total += count;
+        queue.consume(count);
+    }
+    return total;
+}
+
+static void testCrc() {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK(uwbCrc16(check, sizeof(check)) == 0x29B1);
+}
+
+static void testRoundTrip() {
+    UWBRangeRecord range = {};
+    range.timestamp = 0x01000000;     // Zero bytes for COBS to escape
+    range.tagID = 513;
+    range.seq = 0;
+    range.anchorID = 2;
+    range.mask = 0x0B;
+    range.range[0] = 256;
+    range.range[1] = 1234;
+    range.range[3] = 0xFFFF;
+
+    UWBPositionRecord position = {};
+    position.timestamp = 987654321;
+    position.tagID = 7;
+    position.seq = 65535;
+    position.x = -12345;
+    position.y = 0;
+    position.residual = 0xFFFF;
+    position.mask = 0;
+    position.flags = POSITION_UPLOADED;
+
+    uint8_t payload[UWB_MAX_FRAME];
+    UWBFrameQueue queue;
+    int length = encodeRangeRecord(range, payload);
+    CHECK(queue.push(FRAME_RANGE, payload, length));
+    length = encodePositionRecord(position, payload);
+    CHECK(length == 20);
+    CHECK(queue.push(FRAME_POSITION, payload, length));
+
+    uint8_t bytes[256];
+    int count = drain(queue, bytes, sizeof(bytes));
+    // Only the delimiters are zero
+    int zeros = 0;
+    for (int i = 0; i < count; i++) zeros += bytes[i] == 0;
+    CHECK(zeros == 2);
+
+    UWBFrameDecoder decoder;
+    int frames = 0;
+    for (int i = 0; i < count; i++) {
+        if (!decoder.feed(bytes[i])) continue;
+        frames++;
+        if (decoder.frameType() == FRAME_RANGE) {
+            UWBRangeRecord out;
+            CHECK(decodeRangeRecord(decoder.payload(), decoder.payloadLength(), out));
+            CHECK(out.timestamp == range.timestamp);
+            CHECK(out.tagID == range.tagID && out.seq == range.seq);
+            CHECK(out.anchorID == range.anchorID && out.mask == range.mask);
+            CHECK(out.range[0] == 256 && out.range[1] == 1234 && out.range[2] == 0 && out.range[3] == 0xFFFF);
+        } else {
+            CHECK(decoder.frameType() == FRAME_POSITION);
+            UWBPositionRecord out;
+            CHECK(decodePositionRecord(decoder.payload(), decoder.payloadLength(), out));
+            CHECK(out.timestamp == position.timestamp && out.tagID == position.tagID);
+            CHECK(out.seq == position.seq && out.x == position.x && out.y == position.y);
+            CHECK(out.residual == position.residual && out.flags == position.flags);
+        }
+    }
+    CHECK(frames == 2);
+    CHECK(decoder.getCrcErrors() == 0);
+}
+
+static void testCorruption() {
+    UWBPositionRecord position = {};
+    position.tagID = 42;
+    position.x = 1000;
+    position.y = 2000;
+    uint8_t payload[UWB_MAX_FRAME];
+    int length = encodePositionRecord(position, payload);
+
+    UWBFrameQueue queue;
+    CHECK(queue.push(FRAME_POSITION, payload, length));
+    CHECK(queue.push(FRAME_POSITION, payload, length));
+    uint8_t bytes[256];
+    int count = drain(queue, bytes, sizeof(bytes));
+    int first = 0;
+    while (bytes[first] != 0) first++;
+
+    // Flip a bit in the first frame: it fails the CRC, the second decodes
+    bytes[3] ^= 0x10;
+    UWBFrameDecoder decoder;
+    int frames = 0;
+    for (int i = 0; i < count; i++) {
+        if (decoder.feed(bytes[i])) {
+            CHECK(i > first);
+            frames++;
+        }
+    }
+    CHECK(frames == 1);
+    CHECK(decoder.getCrcErrors() == 1);
+
+    // Starting mid-frame (lost bytes): the partial frame is dropped at the
+    // next delimiter and the following frame still decodes
+    UWBFrameDecoder late;
+    frames = 0;
+    for (int i = 5; i < count; i++) frames += late.feed(bytes[i]);
+    CHECK(frames == 1);
+}
+
+static void testQueueFull() {
+    uint8_t payload[20] = {};
+    UWBFrameQueue queue;
+    int pushed = 0;
+    while (queue.push(FRAME_POSITION, payload, sizeof(payload))) pushed++;
+    CHECK(pushed > 0);
+    CHECK(queue.getDropped() == 1);
+    CHECK(queue.used() <= UWBFrameQueue::CAPACITY);
+}
+
+int main() {
+    testCrc();
+    testRoundTrip();
+    testCorruption();
+    testQueueFull();
+    return UWB_TEST_RESULT();
+}
@@ -0,0 +1,105 @@
+// UWBTrajectoryStore delta packing: fixes come back exactly (whole cm,
+// 4 ms stamps), steps beyond a delta's range are split into several
+// deltas that still land on the true fixes, and a step too long for the
+// ring restarts the track.
+
+#include "uwb_test.h"
+#include <UWBTrajectory.h>
+
+static void testPacking() {
+    UWBTrajectoryStore store(2, 16);
+    const float xs[] = {100, 99.6f, -250, -250, 773, 250};
+    const float ys[] = {-40, 983, 983, -40, -1063, -40};
+    const unsigned long times[] = {1000, 1100, 1500, 2000, 4000, 8000};
+    for (int i = 0; i < 6; i++) store.add(1, xs[i], ys[i], times[i]);
+    CHECK(store.getFixCount(0) == 0);
+    CHECK(store.getFixCount(1) == 6);   // Every step fits one delta
+
+    UWBTrajectoryPoint points[16];
+    int n = store.copy(1, points, 16);
+    CHECK(n == 6);
+    for (int i = 0; i < n; i++) {
+        int fix = 5 - i;   // Newest first
+        CHECK_NEAR(points[i].x, std::round(xs[fix]), 0);
+        CHECK_NEAR(points[i].y, std::round(ys[fix]), 0);
+        CHECK(points[i].timestamp == times[fix]);
+    }
+
+    // Older fixes are ignored, stamps are kept in 4 ms units
+    store.add(1, 0, 0, 7000);
+    CHECK(store.getFixCount(1) == 6);
+    store.add(1, 260, -40, 8003);
+    UWBTrajectoryPoint latest;
+    CHECK(store.getLatest(1, latest));
+    CHECK(latest.timestamp == 8000);
+
+    float x, y;
+    CHECK(store.getPositionAt(1, 1048, x, y));
+    CHECK_NEAR(x, 100, 0.01);
+    CHECK_NEAR(y, 451.04, 0.01);
+    CHECK(!store.getPositionAt(1, 500, x, y));   // Before the oldest fix
+}
+
+static void testSplitting() {
+    UWBTrajectoryStore store(1, 32);
+    store.add(0, 0, 0, 0);
+    // 25 m in 100 ms: x needs three deltas
+    store.add(0, 2500, -10, 100);
+    CHECK(store.getFixCount(0) == 4);
+    // 12 s gap without moving: time needs three deltas
+    store.add(0, 2500, -10, 12100);
+    CHECK(store.getFixCount(0) == 7);
+
+    UWBTrajectoryPoint points[32];
+    int n = store.copy(0, points, 32);
+    CHECK(n == 7);
+    CHECK_NEAR(points[0].x, 2500, 0);
+    CHECK(points[0].timestamp == 12100);
+    CHECK_NEAR(points[3].x, 2500, 0);
+    CHECK(points[3].timestamp == 100);
+    CHECK_NEAR(points[6].x, 0, 0);
+    CHECK_NEAR(points[6].y, 0, 0);
+    CHECK(points[6].timestamp == 0);
+    // Filler points lie on the straight line between the true fixes
+    for (int i = 4; i < 6; i++) {
+        CHECK(points[i].x > points[i + 1].x && points[i].x < points[i - 1].x);
+        CHECK_NEAR(points[i].x / 2500.0, points[i].timestamp / 100.0, 0.05);
+    }
+
+    // A step needing more deltas than the ring holds restarts the track
+    UWBTrajectoryStore small(1, 4);
+    small.add(0, 0, 0, 0);
+    small.add(0, 10, 0, 100);
+    small.add(0, 20, 0, 200);
+    CHECK(small.getFixCount(0) == 3);
+    small.add(0, 5000, 0, 300);     // Five deltas, ring holds three
+    CHECK(small.getFixCount(0) == 1);
+    UWBTrajectoryPoint latest;
+    CHECK(small.getLatest(0, latest));
+    CHECK_NEAR(latest.x, 5000, 0);
+
+    // A full ring drops the oldest fixes
+    for (int i = 1; i <= 10; i++) small.add(0, 5000 + i, 0, 300 + i * 100);
+    CHECK(small.getFixCount(0) == 4);
+    n = small.copy(0, points, 32);
+    CHECK(n == 4);
+    CHECK_NEAR(points[3].x, 5007, 0);
+}
+
+static void testVelocity() {
+    UWBTrajectoryStore store(1, 8);
+    CHECK(store.getHeading(0) == -1);
+    for (int i = 0; i <= 20; i++) store.add(0, 0, i * 10.0f, i * 100UL);   // 1 m/s along +Y
+    CHECK_NEAR(store.getSpeed(0), 100, 1);
+    CHECK_NEAR(store.getHeading(0), 90, 1);
+    store.add(0, 0, 200, 20000);    // After a long gap the estimate restarts
+    float vx, vy;
+    CHECK(!store.getVelocity(0, vx, vy));
+}
+
+int main() {
+    testPacking();
+    testSplitting();
+    testVelocity();
+    return UWB_TEST_RESULT();
+}
@@ -0,0 +1,114 @@
+// UWBZoneEngine hysteresis: a tag enters on the zone edge but only exits
+// once it is past the hysteresis band, so jitter on the edge fires one
+// enter and no exits. Covers circles, rectangles and polygons.
+
+#include "uwb_test.h"
+#include <UWBZones.h>
+
+static int enters = 0;
+static int exits = 0;
+static int lastTag = -1;
+static int lastZone = -1;
+
+static void onEnter(int tagID, int zoneID) {
+    enters++;
+    lastTag = tagID;
+    lastZone = zoneID;
+}
+
+static void onExit(int tagID, int zoneID) {
+    exits++;
+    lastTag = tagID;
+    lastZone = zoneID;
+}
+
+static void resetCounts() {
+    enters = exits = 0;
+    lastTag = lastZone = -1;
+}
+
+// Walk a tag in and out across an edge; x values are the positions
+static void jitter(UWBZoneEngine& zones, int slot, int tagID, const float* xs, int count, float y) {
+    for (int i = 0; i < count; i++) zones.update(slot, tagID, xs[i], y);
+}
+
+static void testRect() {
+    UWBZoneEngine zones(4);
+    zones.onEnter(onEnter);
+    zones.onExit(onExit);
+    int rect = zones.addRect(0, 0, 1000, 500);
+    CHECK(rect == 0);
+    zones.setHysteresis(50);
+    resetCounts();
+
+    zones.update(0, 77, -100, 250);
+    CHECK(enters == 0 && !zones.isInside(77, rect));
+    zones.update(0, 77, 0, 250);            // On the edge: inside
+    CHECK(enters == 1 && lastTag == 77 && lastZone == rect);
+
+    // Noise across the edge, never more than 50 cm out
+    const float noise[] = {-20, 10, -49, 5, -30, 0, -45};
+    jitter(zones, 0, 77, noise, 7, 250);
+    CHECK(enters == 1 && exits == 0);
+    CHECK(zones.isInside(77, rect));
+    CHECK(zones.getMembership(77) == 1u);
+
+    zones.update(0, 77, -51, 250);          // Past the band
+    CHECK(exits == 1 && !zones.isInside(77, rect));
+    zones.update(0, 77, -20, 250);          // Inside the band but outside the zone
+    CHECK(enters == 1);
+    zones.update(0, 77, 1, 250);
+    CHECK(enters == 2);
+
+    // Without hysteresis the same noise exits every time it crosses
+    zones.setHysteresis(0);
+    resetCounts();
+    jitter(zones, 0, 77, noise, 7, 250);
+    CHECK(exits == 4 && enters == 3);
+}
+
+static void testCircleAndPolygon() {
+    UWBZoneEngine zones(4);
+    zones.onEnter(onEnter);
+    zones.onExit(onExit);
+    zones.setHysteresis(30);
+    int circle = zones.addCircle(0, 0, 200);
+    const float px[] = {500, 900, 900, 700};
+    const float py[] = {0, 0, 400, 200};
+    int polygon = zones.addPolygon(px, py, 4);
+    CHECK(circle >= 0 && polygon >= 0 && circle != polygon);
+    resetCounts();
+
+    zones.update(1, 5, 190, 0);
+    CHECK(zones.isInside(5, circle));
+    zones.update(1, 5, 225, 0);             // Within the band
+    CHECK(zones.isInside(5, circle) && exits == 0);
+    zones.update(1, 5, 231, 0);
+    CHECK(!zones.isInside(5, circle) && exits == 1);
+
+    // Polygon: a point in the notch is outside; leaving through the
+    // band holds membership, going further drops it
+    zones.update(1, 5, 600, 150);
+    CHECK(!zones.isInside(5, polygon));
+    zones.update(1, 5, 800, 100);
+    CHECK(zones.isInside(5, polygon));
+    zones.update(1, 5, 920, 100);
+    CHECK(zones.isInside(5, polygon));
+    zones.update(1, 5, 940, 100);
+    CHECK(!zones.isInside(5, polygon));
+
+    // A new tag in the slot exits the old one's zones first
+    zones.update(1, 5, 0, 0);
+    resetCounts();
+    zones.update(1, 6, 0, 0);
+    CHECK(exits == 1 && enters == 1 && lastTag == 6);
+    CHECK(!zones.isInside(5, circle) && zones.isInside(6, circle));
+    zones.removeTag(1);
+    CHECK(exits == 2 && zones.getMembership(6) == 0);
+}
+
+int main() {
+    testRect();
+    testCircleAndPolygon();
+    return UWB_TEST_RESULT();
+}
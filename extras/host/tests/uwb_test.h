@@ -0,0 +1,33 @@
+#ifndef UWB_TEST_H
+#define UWB_TEST_H
+
+// Minimal checks for the host tests: each failed CHECK prints its location
+// and the test exits non-zero from UWB_TEST_RESULT().
+
+#include <cmath>
+#include <cstdio>
+
+static int uwbTestFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            uwbTestFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        double uwbActual = (actual), uwbExpected = (expected); \
+        if (!(std::fabs(uwbActual - uwbExpected) <= (tolerance))) { \
+            fprintf(stderr, "%s:%d: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, \
+                    #actual, uwbActual, uwbExpected, (double)(tolerance)); \
+            uwbTestFailures++; \
+        } \
+    } while (0)
+
+#define UWB_TEST_RESULT() \
+    (uwbTestFailures == 0 ? (printf("ok\n"), 0) : (printf("%d failed\n", uwbTestFailures), 1))
+
+#endif
@@ -0,0 +1,353 @@
+// Host-side multilateration companion for DATA_LOGGER anchors.
+//
+// Reads one or more logger streams (text AT+RANGE lines or LOG_BINARY
+// frames, detected automatically) from files, serial ports or stdin and
+// solves every report with the library's own UWBSolver on a work-stealing
+// thread pool. Each tag's fixes are solved in order, each starting from
+// the tag's previous fix (warm start). Position Server streams (streamPositions()) carry fixes
+// that are already solved; those pass straight through. Prints one CSV
+// line per fix:
+//
+//   time_ms,stream,tag,x,y
+//
+// Usage: uwb_host -a 0:0:0 -a 1:0:600 -a 2:380:600 [options] input...
+//   -a ID:X:Y   anchor position in cm (repeat per anchor; not needed for
+//               Position Server streams)
+//   -t N        solver threads (default: all cores)
+//   -b N        reports per solve batch (default 1024)
+//   -B BAUD     baud rate for serial inputs (default 115200)
+//   -I N        least-squares refinement iterations (default 0 = closed form)
+//   -O CM       outlier (NLOS) rejection threshold, cm RMS (default 0 = off)
+//   -q          no CSV output, statistics only
+//   input       file, serial device, or - for stdin
+
+#include <UWBSolver.h>
+#include <UWBStream.h>
+#include <UWBProtocol.h>
+#include "WorkStealingPool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+struct Report {
+    uint64_t order;      // Global arrival order
+    int stream;
+    uint32_t time;       // Logger timestamp (binary) or host ms (text)
+    UWBRangeReport range;
+    bool solved;         // FRAME_POSITION: x/y come from the Position Server
+    float x, y;
+};
+
+struct Fix {
+    bool valid;
+    float x, y;
+    uint8_t rejected;    // Anchors left out as outliers
+};
+
+// Last fix of a tag, the warm start for its next report
+struct Track {
+    bool valid;
+    int stream;          // Report times only compare within a stream
+    uint32_t time;
+    float x, y;
+};
+
+static const uint32_t WARM_START_GAP = 2000;   // ms, older fixes start cold (as UWBMotionFilter)
+
+// Reports handed from reader threads to the solver loop
+class IngestQueue {
+public:
+    IngestQueue(int streams) : _open(streams), _order(0) {}
+
+    void push(Report& report) {
+        std::lock_guard<std::mutex> lock(_lock);
+        report.order = _order++;
+        _reports.push_back(report);
+        if (_reports.size() >= _batch) _ready.notify_one();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(_lock);
+        _open--;
+        _ready.notify_one();
+    }
+
+    // Take up to a batch of reports; false once every stream is closed and drained
+    bool take(std::vector<Report>& out, size_t batch) {
+        std::unique_lock<std::mutex> lock(_lock);
+        _batch = batch;
+        _ready.wait_for(lock, std::chrono::milliseconds(5),
+                        [this] { return _reports.size() >= _batch || _open == 0; });
+        out.swap(_reports);
+        _reports.clear();
+        return !(out.empty() && _open == 0);
+    }
+
+private:
+    std::mutex _lock;
+    std::condition_variable _ready;
+    std::vector<Report> _reports;
+    size_t _batch = 1024;
+    int _open;
+    uint64_t _order;
+};
+
+static uint32_t hostMillis() {
+    static const auto start = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static int openInput(const char* path, int baud) {
+    if (strcmp(path, "-") == 0) return STDIN_FILENO;
+
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) return -1;
+
+    // Serial ports: raw mode at the requested baud rate
+    if (isatty(fd)) {
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            speed_t speed = B115200;
+            switch (baud) {
+                case 9600: speed = B9600; break;
+                case 57600: speed = B57600; break;
+                case 230400: speed = B230400; break;
+                case 460800: speed = B460800; break;
+                case 921600: speed = B921600; break;
+                default: speed = B115200; break;
+            }
+            cfsetispeed(&tio, speed);
+            cfsetospeed(&tio, speed);
+            tio.c_cc[VMIN] = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+    return fd;
+}
+
+// Reader thread: feed every byte to both the line and the frame parser,
+// so text and binary loggers need no configuration
+static void readStream(int fd, int stream, IngestQueue* queue) {
+    UWBFrameDecoder decoder;
+    std::string line;
+    uint8_t buffer[4096];
+    Report report;
+    report.stream = stream;
+    report.solved = false;
+
+    while (true) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+
+        for (ssize_t i = 0; i < n; i++) {
+            uint8_t c = buffer[i];
+
+            if (decoder.feed(c)) {
+                UWBRangeRecord record;
+                UWBPositionRecord position;
+                if (decoder.frameType() == FRAME_POSITION &&
+                    decodePositionRecord(decoder.payload(), decoder.payloadLength(), position)) {
+                    report.time = position.timestamp;
+                    report.range.tagID = position.tagID;
+                    report.range.hasRanges = false;
+                    report.solved = true;
+                    report.x = position.x / 10.0f;
+                    report.y = position.y / 10.0f;
+                    queue->push(report);
+                    report.solved = false;
+                } else if (decoder.frameType() == FRAME_RANGE &&
+                    decodeRangeRecord(decoder.payload(), decoder.payloadLength(), record)) {
+                    report.time = record.timestamp;
+                    report.range.tagID = record.tagID;
+                    report.range.hasRanges = true;
+                    report.range.hasSeq = true;
+                    report.range.hasRssi = false;
+                    report.range.mask = record.mask;
+                    report.range.seq = record.seq;
+                    for (int a = 0; a < 8; a++) {
+                        report.range.range[a] = record.range[a];
+                        report.range.rssi[a] = 0.0;
+                    }
+                    queue->push(report);
+                }
+            }
+
+            if (c == '\n' || c == '\r') {
+                if (!line.empty() && parseRangeReport(line.c_str(), report.range) &&
+                    report.range.hasRanges) {
+                    report.time = hostMillis();
+                    queue->push(report);
+                }
+                line.clear();
+            } else if (c != 0 && line.size() < 512) {
+                line += (char)c;
+            }
+        }
+    }
+
+    if (fd != STDIN_FILENO) close(fd);
+    queue->close();
+}
+
+static void usage() {
+    fprintf(stderr, "usage: uwb_host [-a ID:X:Y ...] [-t threads] [-b batch] [-B baud] [-I iterations] "
+                    "[-O outlier_cm] [-q] input...\n");
+}
+
+int main(int argc, char** argv) {
+    UWBSolver solver;
+    int threads = (int)std::thread::hardware_concurrency();
+    size_t batch = 1024;
+    int baud = 115200;
+    bool quiet = false;
+    int anchors = 0;
+    int iterations = 0;
+    float outlierCm = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "a:t:b:B:I:O:q")) != -1) {
+        switch (opt) {
+            case 'a': {
+                int id;
+                float x, y;
+                if (sscanf(optarg, "%d:%f:%f", &id, &x, &y) != 3) {
+                    usage();
+                    return 2;
+                }
+                solver.setAnchor(id, x, y);
+                anchors++;
+                break;
+            }
+            case 't': threads = atoi(optarg); break;
+            case 'b': batch = (size_t)atoi(optarg); break;
+            case 'B': baud = atoi(optarg); break;
+            case 'I': iterations = atoi(optarg); break;
+            case 'O': outlierCm = atof(optarg); break;
+            case 'q': quiet = true; break;
+            default:
+                usage();
+                return 2;
+        }
+    }
+    // Anchors are only needed to solve range reports
+    if ((anchors > 0 && anchors < 3) || optind >= argc) {
+        usage();
+        return 2;
+    }
+    if (batch < 1) batch = 1;
+    solver.setRefinement(iterations);
+    solver.setOutlierRejection(outlierCm);
+
+    // Start one reader per input stream
+    int streams = argc - optind;
+    IngestQueue queue(streams);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < streams; i++) {
+        int fd = openInput(argv[optind + i], baud);
+        if (fd < 0) {
+            fprintf(stderr, "uwb_host: cannot open %s\n", argv[optind + i]);
+            queue.close();
+            continue;
+        }
+        readers.emplace_back(readStream, fd, i, &queue);
+    }
+
+    WorkStealingPool pool(threads);
+    std::vector<Report> reports;
+    std::vector<Fix> fixes;
+    std::map<int, std::vector<size_t> > byTag;
+    std::map<int, Track> tracks;
+    uint64_t totalReports = 0;
+    uint64_t totalFixes = 0;
+    uint64_t totalRejected = 0;
+    auto started = std::chrono::steady_clock::now();
+
+    if (!quiet) printf("time_ms,stream,tag,x,y\n");
+
+    while (queue.take(reports, batch)) {
+        if (reports.empty()) continue;
+
+        // One job per tag keeps each tag's reports in order
+        byTag.clear();
+        for (size_t i = 0; i < reports.size(); i++) {
+            byTag[reports[i].range.tagID].push_back(i);
+        }
+        fixes.assign(reports.size(), Fix());
+
+        for (auto& entry : byTag) {
+            const std::vector<size_t>* indexes = &entry.second;
+            Track* track = &tracks[entry.first];   // Created here, touched only by this tag's job
+            pool.submit([&solver, &reports, &fixes, indexes, track] {
+                float weights[8];
+                for (size_t index : *indexes) {
+                    Fix& fix = fixes[index];
+                    fix.rejected = 0;
+                    if (reports[index].solved) {
+                        fix.valid = true;
+                        fix.x = reports[index].x;
+                        fix.y = reports[index].y;
+                        continue;
+                    }
+                    const Report& report = reports[index];
+                    const UWBRangeReport& range = report.range;
+                    for (int a = 0; a < 8; a++) {
+                        weights[a] = UWBSolver::rssiWeight(range.rssi[a]);
+                    }
+                    bool warmStart = track->valid && track->stream == report.stream &&
+                                     report.time - track->time < WARM_START_GAP;
+                    fix.x = track->x;
+                    fix.y = track->y;
+                    fix.valid = solver.solve(range.range, range.mask, range.hasRssi ? weights : nullptr,
+                                             fix.x, fix.y, warmStart, &fix.rejected);
+                    if (fix.valid) {
+                        track->valid = true;
+                        track->stream = report.stream;
+                        track->time = report.time;
+                        track->x = fix.x;
+                        track->y = fix.y;
+                    }
+                }
+            });
+        }
+        pool.wait();
+
+        // Emit in arrival order
+        for (size_t i = 0; i < reports.size(); i++) {
+            if (!fixes[i].valid) continue;
+            totalFixes++;
+            totalRejected += __builtin_popcount(fixes[i].rejected);
+            if (!quiet) {
+                printf("%u,%d,%d,%.1f,%.1f\n", reports[i].time, reports[i].stream,
+                       reports[i].range.tagID, fixes[i].x, fixes[i].y);
+            }
+        }
+        totalReports += reports.size();
+    }
+
+    for (size_t i = 0; i < readers.size(); i++) {
+        readers[i].join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    fprintf(stderr, "uwb_host: %llu reports, %llu fixes, %llu outlier ranges, %d threads, %llu steals, "
+            "%.3f s (%.0f reports/s)\n",
+            (unsigned long long)totalReports, (unsigned long long)totalFixes,
+            (unsigned long long)totalRejected, pool.size(),
+            (unsigned long long)pool.steals(), seconds, seconds > 0 ? totalReports / seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,719 @@
+// Synthetic multi-tag load generator for Position Server capacity planning.
+//
+// Runs the real library classes - one UWBAnchor(POSITION_SERVER) and M
+// UWBTAG instances - against simulated MaUWB modules on a virtual clock
+// (see arduino/Arduino.h). Tags move at random through the anchor area;
+// their modules emit AT+RANGE reports with range noise and per-anchor
+// dropout, which reach the tag itself and the server over a 115200 baud
+// UART model with the ESP32's bounded RX buffer. The server's AT+DATA
+// broadcasts come back to every tag as AT+RDATA lines. Server update()
+// calls are timed on the host and scaled to target time, so a slow pass
+// delays the next one and the UART keeps filling meanwhile.
+//
+// Prints one CSV line per tag count:
+//
+//   tags,period_ms,reports_per_s,fixes_per_s,server_cpu_pct,loop_p99_us,
+//   loop_max_us,backlog_mean,backlog_max,module_drops,rx_overflow,
+//   link_quality,broadcast_bytes,tag_drops,fix_err_cm,fix_err_p95_cm,
+//   view_err_cm,peer_err_cm,allocs_per_report,ingest_allocs_per_report,
+//   tag_fixes_per_s,peer_pred_err_cm,sync_err_ms
+//
+//   period_ms       report period per tag (rate, or the air slot limit)
+//   server_cpu_pct  share of target time spent in update() beyond an idle pass
+//   loop_*_us       target time per update() call
+//   backlog_*       reports waiting for the server (module queue + RX buffer)
+//   module_drops    reports the server's module discarded (buffer full)
+//   rx_overflow     bytes lost because the RX buffer was full
+//   link_quality    mean received/expected over the server's tags
+//   tag_drops       lines the tags' modules discarded (mostly oversized broadcasts)
+//   fix_err_cm      server fix vs. true position when the report was made
+//   view_err_cm     server table vs. true position now (adds latency)
+//   peer_err_cm     tag 0's copy of the other tags (adds broadcast latency)
+//   allocs_per_report  heap allocations in the server's tasks per report
+//                   (the simulated modules' own are left out)
+//   ingest_allocs_per_report  the part charged to TASK_INGEST
+//   tag_fixes_per_s fixes the tags accepted for themselves (all tags)
+//   peer_pred_err_cm  tag 0's prediction of the other tags to now
+//   sync_err_ms     tags' clock offset estimate vs. the simulated clocks
+//                   (at the end of the run, '-' without -t)
+//
+// Usage: uwb_loadgen [options]
+//   -a ID:X:Y   anchor position in cm (repeat; default 4 anchors, 1000x800 cm)
+//   -m LIST     tag counts, comma separated (default 1,2,4,...,256)
+//   -r HZ       report rate per tag (default 10)
+//   -s MS       air slot per tag (default 10, as AT+SETCAP); 0 = no air limit
+//   -n CM       range noise sigma (default 10)
+//   -p P        per-anchor dropout probability (default 0.05)
+//   -o P        per-range NLOS probability: adds 50-300 cm (default 0)
+//   -O CM       outlier rejection threshold on server and tags (default 0 = off)
+//   -f TYPE     range prefilter on server and tags: none, median, hampel (default none)
+//   -g CM/S     range prefilter rate gate (default 0 = off)
+//   -t MS       tag clock sync interval (default 0 = off)
+//   -k PPM      tag clock drift, random within +-PPM (default 20); each
+//               tag's clock also starts at a random offset of up to 60 s
+//   -U HOURS    server uptime when the tags boot (default 0): the server's
+//               clock runs this far ahead of theirs
+//   -v CM/S     tag speed (default 100)
+//   -d S        simulated seconds per point, after 3 s warm-up (default 20)
+//   -c X        target time per host CPU time (default 20)
+//   -R BYTES    UART RX buffer (default 256, the ESP32 core's)
+//   -M BYTES    module output buffer (default 2048)
+//   -S SEED     random seed (default 1)
+//
+// Module buffer size and CPU scale are estimates; calibrate -c against
+// printTaskStats() from real hardware for absolute numbers.
+
+#include <UWB-MaUWB-AT.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+static const double BYTE_US = 1e6 / 11520.0;       // 115200 baud, 8N1
+static const int TX_FIFO = 128;                    // ESP32 UART FIFO; writes block beyond it
+static const uint64_t STEP_US = 100;               // Simulation step
+static const uint64_t TAG_STEP_US = 1000;          // Tags run update() every ms
+static const uint64_t LOOP_US = 5;                 // Minimum target time per server loop()
+static const uint64_t WARMUP_US = 3000000;
+static const uint64_t VIEW_SAMPLE_US = 100000;
+static const uint64_t PEER_SAMPLE_US = 500000;
+
+struct AnchorPos {
+    int id;
+    float x, y;
+};
+
+struct Options {
+    std::vector<AnchorPos> anchors;
+    std::vector<int> tagCounts;
+    float rate = 10;
+    float slotMs = 10;
+    float noise = 10;
+    float dropout = 0.05f;
+    float nlos = 0;        // Per-range probability of a reflected (long) path
+    float outlierCm = 0;   // outlierRejection() threshold, 0 = off
+    RangeFilterType filter = RANGE_FILTER_NONE;
+    float gateSpeed = 0;   // rangeGate(), 0 = off
+    int syncMs = 0;        // clockSync() interval, 0 = off
+    float driftPpm = 20;   // Tag clocks run up to this fast or slow
+    float uptimeHours = 0; // Server clock ahead of the tags' by this much
+    float speed = 100;
+    float seconds = 20;
+    float cpuScale = 20;
+    int rxBuffer = 256;
+    int moduleBuffer = 2048;
+    int uploadMs = 0;      // 0 = the server solves every tag
+    int solveMs = 0;       // Server solve interval per tag
+    unsigned seed = 1;
+};
+
+// Allocations charged to the library's scheduled tasks
+static uint32_t taskAllocations() {
+    uint32_t total = 0;
+    for (int task = 0; task < TASK_COUNT; task++) {
+        UWBAllocCount count;
+        uwbAllocGet(task, count);
+        total += count.allocations;
+    }
+    return total;
+}
+
+// One MaUWB module as seen from its host's Serial2: lines queued by the
+// module are clocked into a bounded RX buffer at the baud rate, complete
+// command lines written by the host are handed to onCommand.
+class SimModule : public HostSerialPort {
+public:
+    SimModule(int rxBuffer, int moduleBuffer)
+        : lineDrops(0), rxOverflow(0), _rx(rxBuffer), _rxHead(0), _rxCount(0),
+          _moduleBuffer(moduleBuffer), _queuedBytes(0), _offset(0), _lastPump(0), _txDoneAt(0) {}
+
+    // Module output; false if its buffer is full and the line is dropped
+    bool queueLine(const std::string& line) {
+        pump();
+        if (_queuedBytes + (int)line.size() + 2 > _moduleBuffer) {
+            lineDrops++;
+            return false;
+        }
+        if (_queue.empty()) _lastPump = std::max(_lastPump, (double)hostMicros());
+        int bucket = uwbAllocSetBucket(UWB_ALLOC_OTHER);   // The simulation's heap, not the library's
+        _queue.push_back(line + "\r\n");
+        uwbAllocSetBucket(bucket);
+        _queuedBytes += line.size() + 2;
+        return true;
+    }
+
+    int available() override {
+        pump();
+        return _rxCount;
+    }
+
+    int read() override {
+        pump();
+        if (_rxCount == 0) return -1;
+        char c = _rx[_rxHead];
+        _rxHead = (_rxHead + 1) % _rx.size();
+        _rxCount--;
+        return (uint8_t)c;
+    }
+
+    int peek() override {
+        pump();
+        return _rxCount ? (uint8_t)_rx[_rxHead] : -1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        // Bytes beyond the TX FIFO block the caller until they go out
+        double now = hostMicros();
+        if (_txDoneAt < now) _txDoneAt = now;
+        _txDoneAt += size * BYTE_US;
+        double blocked = _txDoneAt - now - TX_FIFO * BYTE_US;
+        if (blocked > 0) hostStall((uint64_t)blocked);
+
+        int bucket = uwbAllocSetBucket(UWB_ALLOC_OTHER);
+        for (size_t i = 0; i < size; i++) {
+            char c = (char)buffer[i];
+            if (c == '\n') {
+                if (!_command.empty() && onCommand) onCommand(_command);
+                _command.clear();
+            } else if (c != '\r') {
+                _command += c;
+            }
+        }
+        uwbAllocSetBucket(bucket);
+        return size;
+    }
+
+    // Reports waiting for the host: queued in the module or in the RX buffer
+    int pendingLines() {
+        pump();
+        int lines = (int)_queue.size();
+        for (int i = 0; i < _rxCount; i++) {
+            if (_rx[(_rxHead + i) % _rx.size()] == '\n') lines++;
+        }
+        return lines;
+    }
+
+    std::function<void(const std::string&)> onCommand;
+    uint64_t lineDrops;
+    uint64_t rxOverflow;
+
+private:
+    void pump() {
+        double now = hostMicros();
+        if (_queue.empty() || now <= _lastPump) {
+            if (_queue.empty() && now > _lastPump) _lastPump = now;
+            return;
+        }
+        long bytes = (long)((now - _lastPump) / BYTE_US);
+        _lastPump += bytes * BYTE_US;
+        while (bytes-- > 0 && !_queue.empty()) {
+            const std::string& line = _queue.front();
+            if (_rxCount < (int)_rx.size()) {
+                _rx[(_rxHead + _rxCount) % _rx.size()] = line[_offset];
+                _rxCount++;
+            } else {
+                rxOverflow++;
+            }
+            _queuedBytes--;
+            if (++_offset == line.size()) {
+                _queue.pop_front();
+                _offset = 0;
+            }
+        }
+        if (_queue.empty()) _lastPump = now;
+    }
+
+    std::vector<char> _rx;
+    int _rxHead;
+    int _rxCount;
+    int _moduleBuffer;
+    std::deque<std::string> _queue;
+    int _queuedBytes;
+    size_t _offset;
+    double _lastPump;
+    double _txDoneAt;
+    std::string _command;
+};
+
+struct SimTag {
+    UWBTAG* device;
+    SimModule* module;
+    float x, y;            // True position (cm)
+    float goalX, goalY;    // Current waypoint
+    uint64_t nextReport;
+    uint32_t seq;
+    unsigned long lastFix; // positionTime of the tag's own latest fix
+    long clockOffset;      // ms ahead of the server's clock at time 0
+    float clockDrift;      // ppm
+    float reportX[256];    // True position per module sequence number
+    float reportY[256];
+};
+
+struct Metrics {
+    uint64_t reports = 0;
+    std::vector<uint32_t> loopUs;
+    double backlogSum = 0;
+    uint64_t backlogSamples = 0;
+    int backlogMax = 0;
+    size_t broadcastBytes = 0;
+    std::vector<float> fixError;
+    double viewErrorSum = 0;
+    uint64_t viewSamples = 0;
+    double peerErrorSum = 0;
+    uint64_t peerSamples = 0;
+    double predErrorSum = 0;
+    uint64_t predSamples = 0;
+    uint64_t serverAllocs = 0;
+    uint64_t ingestAllocs = 0;
+    uint64_t tagFixes = 0;
+};
+
+// onPosition has no user pointer, so the running simulation is global
+static UWBAnchor* g_server = nullptr;
+static std::vector<SimTag>* g_tags = nullptr;
+static Metrics* g_metrics = nullptr;
+static bool g_measuring = false;
+
+static void onServerFix(int tagID, float x, float y, uint32_t seq, unsigned long timestamp) {
+    (void)seq; (void)timestamp;
+    if (!g_measuring || tagID < 0 || tagID >= (int)g_tags->size()) return;
+    const SimTag& tag = (*g_tags)[tagID];
+    int slot = g_server->getTagSeq(tagID) & 0xFF;
+    int bucket = uwbAllocSetBucket(UWB_ALLOC_OTHER);
+    g_metrics->fixError.push_back(std::hypot(x - tag.reportX[slot], y - tag.reportY[slot]));
+    uwbAllocSetBucket(bucket);
+}
+
+static float percentile(std::vector<float>& values, float p) {
+    if (values.empty()) return 0;
+    size_t k = (size_t)(p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+static void pickWaypoint(SimTag& tag, float minX, float minY, float maxX, float maxY, std::mt19937& rng) {
+    std::uniform_real_distribution<float> ux(minX, maxX), uy(minY, maxY);
+    tag.goalX = ux(rng);
+    tag.goalY = uy(rng);
+}
+
+// Module output for one ranging round of a tag at its true position
+static std::string rangeLine(int tagID, SimTag& tag, const Options& options, std::mt19937& rng) {
+    std::normal_distribution<float> noise(0, options.noise);
+    std::normal_distribution<float> fading(0, 2);
+    std::uniform_real_distribution<float> chance(0, 1);
+    int range[8] = {0};
+    float rssi[8] = {0};
+    uint8_t mask = 0;
+    for (const AnchorPos& anchor : options.anchors) {
+        if (chance(rng) < options.dropout) continue;
+        float d = std::hypot(tag.x - anchor.x, tag.y - anchor.y);
+        if (options.nlos > 0 && chance(rng) < options.nlos) {
+            d += 50.0f + 250.0f * chance(rng);
+        }
+        int measured = (int)std::lround(d + noise(rng));
+        if (measured < 1) measured = 1;
+        range[anchor.id] = measured;
+        rssi[anchor.id] = -60.0f - 20.0f * std::log10(std::max(d, 100.0f) / 100.0f) + fading(rng);
+        mask |= 1 << anchor.id;
+    }
+
+    uint32_t seq = tag.seq++ & 0xFF;
+    tag.reportX[seq] = tag.x;
+    tag.reportY[seq] = tag.y;
+
+    char line[256];
+    int n = snprintf(line, sizeof(line), "AT+RANGE=tid:%d,mask:%02X,seq:%u,range:(", tagID, mask, seq);
+    for (int i = 0; i < 8; i++) {
+        n += snprintf(line + n, sizeof(line) - n, i ? ",%d" : "%d", range[i]);
+    }
+    n += snprintf(line + n, sizeof(line) - n, "),rssi:(");
+    for (int i = 0; i < 8; i++) {
+        n += snprintf(line + n, sizeof(line) - n, i ? ",%.1f" : "%.1f", rssi[i]);
+    }
+    snprintf(line + n, sizeof(line) - n, ")");
+    return line;
+}
+
+static void runPoint(int tagCount, const Options& options, std::mt19937& rng) {
+    float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f;
+    for (const AnchorPos& anchor : options.anchors) {
+        minX = std::min(minX, anchor.x);
+        minY = std::min(minY, anchor.y);
+        maxX = std::max(maxX, anchor.x);
+        maxY = std::max(maxY, anchor.y);
+    }
+
+    // Devices run their normal setup against the simulated modules
+    long serverClock = (long)(options.uptimeHours * 3600000.0);
+    hostSetIdleAdvance(true);
+    hostSetClock(serverClock, 0);
+    SimModule serverModule(options.rxBuffer, options.moduleBuffer);
+    Serial2.setPort(&serverModule);
+    UWBAnchor* server = new UWBAnchor(POSITION_SERVER);
+    server->setAnchorNumber(0);
+    server->totalTags(tagCount);
+    server->solveInterval(options.solveMs);
+    server->outlierRejection(options.outlierCm);
+    if (options.filter != RANGE_FILTER_NONE) server->rangeFilter(options.filter);
+    if (options.gateSpeed > 0) server->rangeGate(options.gateSpeed);
+    for (const AnchorPos& anchor : options.anchors) {
+        server->setOtherAnchor(anchor.id, anchor.x, anchor.y);
+    }
+    server->onPosition(onServerFix);
+
+    // Tag clocks: own random stream, so the motion and noise stay as without
+    std::mt19937 clockRng(options.seed + tagCount);
+    std::uniform_int_distribution<long> clockStart(0, 60000);
+    std::uniform_real_distribution<float> clockRate(-options.driftPpm, options.driftPpm);
+
+    std::vector<SimTag> tags(tagCount);
+    for (int i = 0; i < tagCount; i++) {
+        SimTag& tag = tags[i];
+        tag.clockOffset = clockStart(clockRng);
+        tag.clockDrift = clockRate(clockRng);
+        tag.module = new SimModule(256, options.moduleBuffer);
+        Serial2.setPort(tag.module);
+        hostSetClock(tag.clockOffset, tag.clockDrift);
+        tag.device = new UWBTAG();
+        tag.device->setTagNumber(i);
+        tag.device->totalTags(tagCount);
+        if (options.uploadMs > 0) tag.device->uploadFixes(options.uploadMs);
+        tag.device->outlierRejection(options.outlierCm);
+        if (options.filter != RANGE_FILTER_NONE) tag.device->rangeFilter(options.filter);
+        if (options.gateSpeed > 0) tag.device->rangeGate(options.gateSpeed);
+        if (options.syncMs > 0) tag.device->clockSync(options.syncMs);
+        for (const AnchorPos& anchor : options.anchors) {
+            if (anchor.id == 0) tag.device->anchor0(anchor.x, anchor.y);
+            if (anchor.id == 1) tag.device->anchor1(anchor.x, anchor.y);
+            if (anchor.id == 2) tag.device->anchor2(anchor.x, anchor.y);
+            if (anchor.id == 3) tag.device->anchor3(anchor.x, anchor.y);
+        }
+        std::uniform_real_distribution<float> ux(minX, maxX), uy(minY, maxY);
+        tag.x = ux(rng);
+        tag.y = uy(rng);
+        pickWaypoint(tag, minX, minY, maxX, maxY, rng);
+        tag.seq = 0;
+        tag.lastFix = 0;
+    }
+    hostSetClock(serverClock, 0);
+    hostSetIdleAdvance(false);
+
+    // Server broadcasts reach every tag's module
+    Metrics metrics;
+    serverModule.onCommand = [&](const std::string& command) {
+        if (command.compare(0, 8, "AT+DATA=") != 0) return;
+        size_t comma = command.find(',');
+        if (comma == std::string::npos) return;
+        metrics.broadcastBytes = std::max(metrics.broadcastBytes, command.size() + 2);
+        std::string line = "AT+RDATA=0,0," + std::to_string(millis()) + "," +
+                           command.substr(8, comma - 8) + "," + command.substr(comma + 1);
+        for (SimTag& tag : tags) tag.module->queueLine(line);
+    };
+
+    // Fixes uploaded by tags reach the server's module
+    for (int i = 0; i < tagCount; i++) {
+        tags[i].module->onCommand = [&serverModule, i](const std::string& command) {
+            if (command.compare(0, 8, "AT+DATA=") != 0) return;
+            size_t comma = command.find(',');
+            if (comma == std::string::npos) return;
+            serverModule.queueLine("AT+RDATA=" + std::to_string(i) + ",0," + std::to_string(millis()) + "," +
+                                   command.substr(8, comma - 8) + "," + command.substr(comma + 1));
+        };
+    }
+
+    g_server = server;
+    g_tags = &tags;
+    g_metrics = &metrics;
+
+    // TDMA: each tag reports once per period, spread evenly over it
+    float periodMs = std::max(1000.0f / options.rate, tagCount * options.slotMs);
+    uint64_t period = (uint64_t)(periodMs * 1000);
+    uint64_t start = hostTime();
+    for (int i = 0; i < tagCount; i++) {
+        tags[i].nextReport = start + period * i / tagCount;
+    }
+
+    uint64_t warm = start + WARMUP_US;
+    uint64_t end = warm + (uint64_t)(options.seconds * 1e6);
+    uint64_t serverFree = start;
+    uint64_t nextTagStep = start;
+    uint64_t nextView = warm;
+    uint64_t nextPeer = warm;
+    uint64_t dropsAtWarm = 0, overflowAtWarm = 0, tagDropsAtWarm = 0;
+    float stepDistance = options.speed * TAG_STEP_US / 1e6f;
+
+    for (uint64_t t = start; t < end; t += STEP_US) {
+        hostSetTime(t);
+        if (!g_measuring && t >= warm) {
+            g_measuring = true;
+            dropsAtWarm = serverModule.lineDrops;
+            overflowAtWarm = serverModule.rxOverflow;
+            for (SimTag& tag : tags) tagDropsAtWarm += tag.module->lineDrops;
+        }
+
+        // Ranging rounds due now go to the tag and the server
+        for (int i = 0; i < tagCount; i++) {
+            SimTag& tag = tags[i];
+            if (t < tag.nextReport) continue;
+            tag.nextReport += period;
+            std::string line = rangeLine(i, tag, options, rng);
+            tag.module->queueLine(line);
+            serverModule.queueLine(line);
+            if (g_measuring) metrics.reports++;
+        }
+
+        // Server loop(): the next pass starts once this one has finished
+        if (t >= serverFree) {
+            Serial2.setPort(&serverModule);
+            UWBAllocCount ingestBefore, ingestAfter;
+            uwbAllocGet(TASK_INGEST, ingestBefore);
+            uint32_t allocsBefore = taskAllocations();
+            hostBeginBusy();
+            server->update();
+            uint64_t busy = hostEndBusy();
+            serverFree = t + std::max(busy, LOOP_US);
+            if (g_measuring) {
+                metrics.loopUs.push_back((uint32_t)busy);
+                uwbAllocGet(TASK_INGEST, ingestAfter);
+                metrics.serverAllocs += taskAllocations() - allocsBefore;
+                metrics.ingestAllocs += ingestAfter.allocations - ingestBefore.allocations;
+            }
+        }
+
+        if (t >= nextTagStep) {
+            nextTagStep += TAG_STEP_US;
+            for (SimTag& tag : tags) {
+                float dx = tag.goalX - tag.x, dy = tag.goalY - tag.y;
+                float d = std::hypot(dx, dy);
+                if (d <= stepDistance) {
+                    pickWaypoint(tag, minX, minY, maxX, maxY, rng);
+                } else {
+                    tag.x += dx / d * stepDistance;
+                    tag.y += dy / d * stepDistance;
+                }
+                Serial2.setPort(tag.module);
+                hostSetClock(tag.clockOffset, tag.clockDrift);
+                tag.device->update();
+                if (tag.device->positionTime != tag.lastFix) {
+                    tag.lastFix = tag.device->positionTime;
+                    if (g_measuring) metrics.tagFixes++;
+                }
+            }
+            hostSetClock(serverClock, 0);
+            if (g_measuring) {
+                int backlog = serverModule.pendingLines();
+                metrics.backlogSum += backlog;
+                metrics.backlogSamples++;
+                metrics.backlogMax = std::max(metrics.backlogMax, backlog);
+            }
+        }
+
+        if (t >= nextView) {
+            nextView += VIEW_SAMPLE_US;
+            Serial2.setPort(&serverModule);
+            for (int i = 0; i < tagCount; i++) {
+                if (!server->isTagActive(i)) continue;
+                metrics.viewErrorSum += std::hypot(server->getTagX(i) - tags[i].x, server->getTagY(i) - tags[i].y);
+                metrics.viewSamples++;
+            }
+        }
+
+        if (t >= nextPeer) {
+            nextPeer += PEER_SAMPLE_US;
+            hostSetClock(tags[0].clockOffset, tags[0].clockDrift);
+            for (int i = 1; i < tagCount; i++) {
+                if (!tags[0].device->isTagActive(i)) continue;
+                metrics.peerErrorSum += std::hypot(tags[0].device->getTagX(i) - tags[i].x,
+                                                   tags[0].device->getTagY(i) - tags[i].y);
+                metrics.peerSamples++;
+                float x, y;
+                if (tags[0].device->getPredictedPosition(i, x, y)) {
+                    metrics.predErrorSum += std::hypot(x - tags[i].x, y - tags[i].y);
+                    metrics.predSamples++;
+                }
+            }
+            hostSetClock(serverClock, 0);
+        }
+    }
+    g_measuring = false;
+
+    uint64_t tagDrops = 0;
+    for (SimTag& tag : tags) tagDrops += tag.module->lineDrops;
+
+    // Offset error: server clock minus each tag's, as the tag reads it now
+    double syncErrorSum = 0;
+    int syncedTags = 0;
+    for (SimTag& tag : tags) {
+        hostSetClock(tag.clockOffset, tag.clockDrift);
+        if (!tag.device->isClockSynced()) continue;
+        double trueOffset = hostTime() / 1000.0 + serverClock - (double)millis();
+        syncErrorSum += std::fabs(tag.device->getClockOffset() - trueOffset);
+        syncedTags++;
+    }
+    hostSetClock(serverClock, 0);
+
+    double quality = 0;
+    int qualityCount = 0;
+    for (int i = 0; i < tagCount; i++) {
+        if (server->isTagActive(i)) {
+            quality += server->getLinkQuality(i);
+            qualityCount++;
+        }
+    }
+
+    // Most passes find nothing to do; their cost is the loop's floor
+    std::vector<uint32_t>& loops = metrics.loopUs;
+    std::sort(loops.begin(), loops.end());
+    uint32_t idle = loops.empty() ? 0 : loops[loops.size() / 2];
+    uint64_t workUs = 0;
+    for (uint32_t us : loops) workUs += (us > idle) ? us - idle : 0;
+    uint32_t loopP99 = loops.empty() ? 0 : loops[(size_t)(0.99 * (loops.size() - 1))];
+    uint32_t loopMax = loops.empty() ? 0 : loops.back();
+    float fixMean = 0;
+    for (float e : metrics.fixError) fixMean += e;
+    if (!metrics.fixError.empty()) fixMean /= metrics.fixError.size();
+    float fixP95 = percentile(metrics.fixError, 0.95f);
+
+    printf("%d,%.0f,%.1f,%.1f,%.2f,%u,%u,%.2f,%d,%llu,%llu,%.3f,%zu,%llu,%.1f,%.1f,%.1f,",
+           tagCount, periodMs, metrics.reports / options.seconds, metrics.fixError.size() / options.seconds,
+           100.0 * workUs / (end - warm), loopP99, loopMax,
+           metrics.backlogSamples ? metrics.backlogSum / metrics.backlogSamples : 0.0, metrics.backlogMax,
+           (unsigned long long)(serverModule.lineDrops - dropsAtWarm),
+           (unsigned long long)(serverModule.rxOverflow - overflowAtWarm),
+           qualityCount ? quality / qualityCount : 0.0, metrics.broadcastBytes,
+           (unsigned long long)(tagDrops - tagDropsAtWarm),
+           fixMean, fixP95,
+           metrics.viewSamples ? metrics.viewErrorSum / metrics.viewSamples : 0.0);
+    if (metrics.peerSamples > 0) {
+        printf("%.1f,", metrics.peerErrorSum / metrics.peerSamples);
+    } else {
+        printf("-,");
+    }
+    double reports = metrics.reports ? (double)metrics.reports : 1.0;
+    printf("%.2f,%.2f,%.1f,", metrics.serverAllocs / reports, metrics.ingestAllocs / reports,
+           metrics.tagFixes / options.seconds);
+    if (metrics.predSamples > 0) {
+        printf("%.1f,", metrics.predErrorSum / metrics.predSamples);
+    } else {
+        printf("-,");
+    }
+    if (syncedTags > 0) {
+        printf("%.2f\n", syncErrorSum / syncedTags);
+    } else {
+        printf("-\n");
+    }
+    fflush(stdout);
+
+    Serial2.setPort(nullptr);
+    delete server;
+    for (SimTag& tag : tags) {
+        delete tag.device;
+        delete tag.module;
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "usage: uwb_loadgen [-a ID:X:Y]... [-m N,N,...] [-r hz] [-s slot_ms] [-n cm] [-p dropout]\n"
+                    "                   [-o nlos] [-O outlier_cm] [-f none|median|hampel] [-g cm/s] [-t sync_ms]\n"
+                    "                   [-k ppm] [-U hours] [-v cm/s] [-d seconds] [-c cpu_scale] [-R rx_bytes] [-M module_bytes]\n"
+                    "                   [-u ms] [-i solve_ms] [-S seed]\n");
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    int opt;
+    while ((opt = getopt(argc, argv, "a:m:r:s:n:p:o:O:f:g:t:k:U:v:d:c:R:M:u:i:S:h")) != -1) {
+        switch (opt) {
+            case 'a': {
+                AnchorPos anchor;
+                if (sscanf(optarg, "%d:%f:%f", &anchor.id, &anchor.x, &anchor.y) != 3 ||
+                    anchor.id < 0 || anchor.id >= UWBSolver::MAX_ANCHORS) {
+                    fprintf(stderr, "bad anchor: %s\n", optarg);
+                    return 1;
+                }
+                options.anchors.push_back(anchor);
+                break;
+            }
+            case 'm': {
+                const char* p = optarg;
+                while (*p) {
+                    int count = atoi(p);
+                    if (count < 1 || count > UWB_MAX_TRACKED_TAGS) {
+                        fprintf(stderr, "tag counts must be 1..%d\n", UWB_MAX_TRACKED_TAGS);
+                        return 1;
+                    }
+                    options.tagCounts.push_back(count);
+                    p = strchr(p, ',');
+                    if (p == nullptr) break;
+                    p++;
+                }
+                break;
+            }
+            case 'r': options.rate = atof(optarg); break;
+            case 's': options.slotMs = atof(optarg); break;
+            case 'n': options.noise = atof(optarg); break;
+            case 'p': options.dropout = atof(optarg); break;
+            case 'o': options.nlos = atof(optarg); break;
+            case 'O': options.outlierCm = atof(optarg); break;
+            case 'f':
+                if (strcmp(optarg, "none") == 0) options.filter = RANGE_FILTER_NONE;
+                else if (strcmp(optarg, "median") == 0) options.filter = RANGE_FILTER_MEDIAN;
+                else if (strcmp(optarg, "hampel") == 0) options.filter = RANGE_FILTER_HAMPEL;
+                else {
+                    fprintf(stderr, "bad filter: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'g': options.gateSpeed = atof(optarg); break;
+            case 't': options.syncMs = atoi(optarg); break;
+            case 'k': options.driftPpm = atof(optarg); break;
+            case 'U': options.uptimeHours = atof(optarg); break;
+            case 'v': options.speed = atof(optarg); break;
+            case 'd': options.seconds = atof(optarg); break;
+            case 'c': options.cpuScale = atof(optarg); break;
+            case 'R': options.rxBuffer = atoi(optarg); break;
+            case 'M': options.moduleBuffer = atoi(optarg); break;
+            case 'u': options.uploadMs = atoi(optarg); break;
+            case 'i': options.solveMs = atoi(optarg); break;
+            case 'S': options.seed = (unsigned)atoi(optarg); break;
+            default: usage(); return 1;
+        }
+    }
+    if (options.rate <= 0 || options.seconds <= 0 || options.rxBuffer < 1 || options.uptimeHours < 0 ||
+        options.uptimeHours > 24 * 20) {
+        usage();
+        return 1;
+    }
+    if (options.anchors.empty()) {
+        options.anchors = {{0, 0, 0}, {1, 0, 800}, {2, 1000, 800}, {3, 1000, 0}};
+    }
+    if (options.tagCounts.empty()) {
+        for (int count = 1; count <= UWB_MAX_TRACKED_TAGS; count *= 2) options.tagCounts.push_back(count);
+    }
+
+    hostSetCpuScale(options.cpuScale);
+    std::mt19937 rng(options.seed);
+
+    static const char* filterNames[] = {"none", "median", "hampel"};
+    printf("# rate %.1f Hz, slot %.1f ms, noise %.1f cm, dropout %.2f, nlos %.2f, outlier %.0f cm, filter %s, "
+           "gate %.0f cm/s, sync %d ms, drift %.0f ppm, uptime %.1f h, speed %.0f cm/s, cpu scale %.1f\n", options.rate,
+           options.slotMs, options.noise, options.dropout, options.nlos, options.outlierCm, filterNames[options.filter],
+           options.gateSpeed, options.syncMs, options.driftPpm, options.uptimeHours, options.speed, options.cpuScale);
+    printf("tags,period_ms,reports_per_s,fixes_per_s,server_cpu_pct,loop_p99_us,loop_max_us,backlog_mean,backlog_max,"
+           "module_drops,rx_overflow,link_quality,broadcast_bytes,tag_drops,fix_err_cm,fix_err_p95_cm,view_err_cm,peer_err_cm,"
+           "allocs_per_report,ingest_allocs_per_report,tag_fixes_per_s,peer_pred_err_cm,sync_err_ms\n");
+    for (int count : options.tagCounts) {
+        runPoint(count, options, rng);
+    }
+    return 0;
+}
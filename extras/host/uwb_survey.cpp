@@ -0,0 +1,98 @@
+// Host-side anchor survey.
+//
+// Reads the AT+RANGE lines of an anchor survey (each anchor's USB output
+// during its surveyTurn(), or a DATA_LOGGER's text output while the
+// anchors take their turns) from files or stdin and solves the anchor
+// layout with the library's own UWBSurvey. The tag ID of each report is
+// the anchor that ranged.
+//
+// Prints the measured pairs with how well the layout fits them, then the
+// layout as ANCHOR lines and as the ANCHORS payload the Position Server
+// broadcasts:
+//
+//   pair <a> <b> <range_cm> <count> <fit_error_cm>
+//   ANCHOR <id> <x> <y>
+//   ANCHORS:<id>:<x>:<y>:...
+//
+// Usage: uwb_survey [input...]   (default: stdin, - for stdin)
+
+#include <UWBSurvey.h>
+#include <UWBProtocol.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static int readSurvey(FILE* in, UWBSurvey& survey) {
+    char line[512];
+    int reports = 0;
+    while (fgets(line, sizeof(line), in) != nullptr) {
+        // Logger lines may carry a prefix; the report starts at AT+RANGE=
+        const char* start = strstr(line, "AT+RANGE=");
+        if (start == nullptr) continue;
+        UWBRangeReport report;
+        if (!parseRangeReport(start, report) || !report.hasRanges) continue;
+        if (report.tagID < 0 || report.tagID >= UWBSurvey::MAX_ANCHORS) continue;
+        survey.addReport(report.tagID, report);
+        reports++;
+    }
+    return reports;
+}
+
+int main(int argc, char** argv) {
+    UWBSurvey survey;
+    int reports = 0;
+    if (argc < 2) {
+        reports += readSurvey(stdin, survey);
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0) {
+            fprintf(stderr, "usage: uwb_survey [input...]\n");
+            return 1;
+        }
+        FILE* in = strcmp(argv[i], "-") == 0 ? stdin : fopen(argv[i], "r");
+        if (in == nullptr) {
+            fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        reports += readSurvey(in, survey);
+        if (in != stdin) fclose(in);
+    }
+
+    bool solved = survey.solve();
+    printf("# %d reports, residual %.1f cm\n", reports, survey.getResidual());
+    for (int a = 0; a < UWBSurvey::MAX_ANCHORS; a++) {
+        for (int b = a + 1; b < UWBSurvey::MAX_ANCHORS; b++) {
+            float cm;
+            if (!survey.getRange(a, b, cm)) continue;
+            float ax, ay, bx, by;
+            if (solved && survey.getPosition(a, ax, ay) && survey.getPosition(b, bx, by)) {
+                printf("pair %d %d %.1f %d %.1f\n", a, b, cm, survey.getRangeCount(a, b),
+                       std::hypot(ax - bx, ay - by) - cm);
+            } else {
+                printf("pair %d %d %.1f %d -\n", a, b, cm, survey.getRangeCount(a, b));
+            }
+        }
+    }
+    if (!solved) {
+        fprintf(stderr, "not enough pairs: every anchor needs 2 and the layout 2n-3\n");
+        return 1;
+    }
+
+    UWBAnchorPosition anchors[UWBSurvey::MAX_ANCHORS];
+    int count = 0;
+    for (int id = 0; id < UWBSurvey::MAX_ANCHORS; id++) {
+        float x, y;
+        if (!survey.getPosition(id, x, y)) continue;
+        printf("ANCHOR %d %.1f %.1f\n", id, x, y);
+        anchors[count].id = id;
+        anchors[count].x = x;
+        anchors[count].y = y;
+        count++;
+    }
+    char payload[256];
+    if (formatAnchorList(anchors, count, payload, sizeof(payload)) > 0) {
+        printf("%s\n", payload);
+    }
+    return 0;
+}
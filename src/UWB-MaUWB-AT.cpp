@@ -0,0 +1,2710 @@
+//developed with Claude 3.7
+
+#include "UWB-MaUWB-AT.h"
+#include <cmath> // Include for sqrt() and abs() functions
+
+const float UWBTAG::PREDICTOR_BETA = 0.5;
+
+// One line per registered task:
+// TASK <name> period:<ms> runs:<n> last:<us> max:<us> over:<n> defer:<n>
+static void printTaskLines(Print& out, const UWBScheduler& scheduler) {
+    for (int i = 0; i < TASK_COUNT; i++) {
+        if (scheduler.getName(i)[0] == '\0') continue;
+        out.print("TASK ");
+        out.print(scheduler.getName(i));
+        out.print(scheduler.isEnabled(i) ? "" : " (off)");
+        out.print(" period:");
+        out.print(scheduler.getPeriod(i));
+        out.print(" runs:");
+        out.print((unsigned long)scheduler.getRuns(i));
+        out.print(" last:");
+        out.print(scheduler.getLastTime(i));
+        out.print(" max:");
+        out.print(scheduler.getMaxTime(i));
+        out.print(" over:");
+        out.print((unsigned long)scheduler.getOverruns(i));
+        out.print(" defer:");
+        out.println((unsigned long)scheduler.getDeferred(i));
+    }
+}
+
+// Memory report:
+// MEM heap:<free> min:<lowest free> block:<largest free block> frag:<%> stack:<unused> age:<ms>
+// ALLOC <subsystem> n:<allocations> free:<frees> bytes:<requested> (with UWB_COUNT_ALLOCATIONS)
+static void printMemoryLines(Print& out, const UWBScheduler& scheduler, const UWBMemorySample* sample) {
+    if (sample != nullptr) {
+        out.print("MEM heap:");
+        out.print((unsigned long)sample->freeHeap);
+        out.print(" min:");
+        out.print((unsigned long)sample->minFreeHeap);
+        out.print(" block:");
+        out.print((unsigned long)sample->largestFreeBlock);
+        out.print(" frag:");
+        out.print(sample->freeHeap > 0 ? 100 - (int)((uint64_t)sample->largestFreeBlock * 100 / sample->freeHeap) : 0);
+        out.print(" stack:");
+        out.print((unsigned long)sample->stackHighWater);
+        out.print(" age:");
+        out.println(millis() - sample->time);
+    }
+    if (!uwbAllocCounting()) return;
+    for (int i = 0; i < UWB_ALLOC_BUCKETS; i++) {
+        UWBAllocCount count;
+        uwbAllocGet(i, count);
+        const char* name = (i == UWB_ALLOC_OTHER) ? "other" : scheduler.getName(i);
+        if (name[0] == '\0') continue;
+        out.print("ALLOC ");
+        out.print(name);
+        out.print(" n:");
+        out.print((unsigned long)count.allocations);
+        out.print(" free:");
+        out.print((unsigned long)count.frees);
+        out.print(" bytes:");
+        out.println((unsigned long)count.bytes);
+    }
+}
+
+// Compact one-line link report:
+// LINK tid:<id> rx:<received> exp:<expected> lost:<n> dup:<n> reord:<n> q:<quality> age:<ms>
+static void printLinkLine(Print& out, int tagID, const UWBLinkStats& stats, unsigned long now) {
+    out.print("LINK tid:");
+    out.print(tagID);
+    out.print(" rx:");
+    out.print((unsigned long)stats.getReceived());
+    out.print(" exp:");
+    out.print((unsigned long)stats.getExpected());
+    out.print(" lost:");
+    out.print((unsigned long)stats.getLost());
+    out.print(" dup:");
+    out.print((unsigned int)stats.getDuplicates());
+    out.print(" reord:");
+    out.print((unsigned int)stats.getReorders());
+    out.print(" q:");
+    out.print(stats.getQuality(), 3);
+    out.print(" age:");
+    out.println(stats.getAge(now));
+}
+
+// Module configuration after AT+RESTORE, one command per step: role 0 (tag)
+// or 1 (anchor) with its ID, tag capacity, range reports on, then save and
+// restart. waitMs is how long the module needs before the next step.
+// Setup sends the steps blocking, anchor survey turns one per task run.
+static bool moduleConfigStep(int step, int id, bool anchorRole, int totalTags,
+                             String& command, unsigned long& waitMs) {
+    waitMs = 500;
+    switch (step) {
+        case 0:
+            command = "AT+SETCFG=" + String(id) + (anchorRole ? ",1,1,1" : ",0,1,1");
+            return true;
+        case 1:
+            command = "AT+SETCAP=" + String(totalTags) + ",10,1";
+            return true;
+        case 2:
+            command = "AT+SETRPT=1";
+            return true;
+        case 3:
+            command = "AT+SAVE";
+            return true;
+        case 4:
+            command = "AT+RESTART";
+            waitMs = 1000;
+            return true;
+        default:
+            return false;
+    }
+}
+
+UWBTAG::UWBTAG() : _zones(UWB_ENABLE_MULTITAG ? UWB_MAX_OTHER_TAGS + 1 : 1), _scheduler(micros) {
+    // Initialize variables
+    _tagNumber = 0;
+    _refreshRate = 50;
+    _totalTags = 10;
+#if UWB_ENABLE_DISPLAY
+    _displayInitialized = false;
+#endif
+    _positionHistoryLength = 1;
+    _positionHistoryIndex = 0;
+    _positionHistoryFilled = false;
+    _filterType = FILTER_NONE;
+    _filterAlpha = 0.5;
+    _filterBeta = 0.1;
+    _predictionHorizon = 1000;
+    _solvePending = false;
+    _response = "";
+    _response.reserve(RESPONSE_RESERVE); // Cleared per line, never shrinks: no heap per line
+    _onRange = nullptr;
+    _onPosition = nullptr;
+    _onTagSeen = nullptr;
+    _onTagLost = nullptr;
+    _rangeSeq = 0;
+    _positionSeq = 0;
+    
+    // Initialize positions
+    positionX = 0.0;
+    positionY = 0.0;
+    positionTime = 0;
+    a0Distance = 0.0;
+    a1Distance = 0.0;
+    a2Distance = 0.0;
+    a3Distance = 0.0;
+    
+    // Initialize anchor positions (default)
+    for (int i = 0; i < 4; i++) {
+        _anchorPositions[i][0] = 0.0;
+        _anchorPositions[i][1] = 0.0;
+        _solver.setAnchor(i, 0.0, 0.0);
+    }
+    _rawFixX = 0.0;
+    _rawFixY = 0.0;
+    _rawFixTime = 0;
+    _rawFixValid = false;
+    for (int i = 0; i < UWBSolver::MAX_ANCHORS; i++) {
+        _ranges[i] = 0.0;
+    }
+    _rangeMask = 0;
+    _rejectedAnchors = 0;
+    for (int i = 0; i < UWBSolver::MAX_ANCHORS; i++) {
+        _anchorRejections[i] = 0;
+    }
+    _rangeReportSeq = 0;
+    _uploadPending = false;
+    _fixSeq = 0;
+    _fixResidual = -1.0;
+    _syncPending = false;
+    _syncShard = 0;
+    _trajectories = nullptr;
+    _rangeFilter = nullptr;
+    
+    // Initialize position history
+    for (int i = 0; i < MAX_POSITION_HISTORY; i++) {
+        _positionXHistory[i] = 0.0;
+        _positionYHistory[i] = 0.0;
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    // Initialize other tags tracking
+    _activeOtherTagCount = 0;
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        _otherTags[i].reset();
+    }
+#endif
+    
+    // Scheduled subsystems: id, name, task, period (ms, 0 = every update), priority, budget (ms)
+    _scheduler.setTask(TASK_INGEST, "ingest", taskIngest, this, 0, 255, 5);
+    _scheduler.setTask(TASK_SOLVE, "solve", taskSolve, this, 0, 200, 5);
+    _scheduler.setTask(TASK_RANGING, "ranging", taskRanging, this, _refreshRate, 150, 2);
+#if UWB_ENABLE_DISPLAY
+    _scheduler.setTask(TASK_DISPLAY, "display", taskDisplay, this, _refreshRate, 50, 40);
+#endif
+    _scheduler.setTask(TASK_TELEMETRY, "telemetry", taskTelemetry, this, 1000, 10, 5);
+    _scheduler.setEnabled(TASK_TELEMETRY, false);
+    _scheduler.setTask(TASK_UPLOAD, "upload", taskUpload, this, 100, 120, 2);
+    _scheduler.setEnabled(TASK_UPLOAD, false);
+    _scheduler.setTask(TASK_MEMORY, "memory", taskMemory, this, 1000, 5, 1);
+    _scheduler.setEnabled(TASK_MEMORY, false);
+    _scheduler.setTask(TASK_SYNC, "sync", taskSync, this, 2000, 110, 1);
+    _scheduler.setEnabled(TASK_SYNC, false);
+    _memorySampled = false;
+    
+    // Initialize hardware immediately
+    initializeHardware();
+}
+
+UWBTAG::~UWBTAG() {
+#if UWB_ENABLE_DISPLAY
+    // Free allocated memory for display
+    if (_display != nullptr) {
+        delete _display;
+        _display = nullptr;
+    }
+#endif
+    
+    if (_trajectories != nullptr) {
+        delete _trajectories;
+        _trajectories = nullptr;
+    }
+    if (_rangeFilter != nullptr) {
+        delete _rangeFilter;
+        _rangeFilter = nullptr;
+    }
+}
+
+void UWBTAG::initializeHardware() {
+    // Initialize reset pin
+    pinMode(RESET_PIN, OUTPUT);
+    digitalWrite(RESET_PIN, HIGH);
+    
+    // Initialize Serial2 for UWB communication
+    Serial2.begin(115200, SERIAL_8N1, IO_RXD2, IO_TXD2);
+    
+#if UWB_ENABLE_DISPLAY
+    // Initialize I2C
+    Wire.begin(I2C_SDA, I2C_SCL);
+#endif
+    
+    delay(500);
+    
+#if UWB_ENABLE_DISPLAY
+    // Initialize display
+    _display = new Adafruit_SSD1306(128, 64, &Wire, -1);
+    if (_display->begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+        _displayInitialized = true;
+        _display->clearDisplay();
+        _display->setTextColor(SSD1306_WHITE);
+        
+        // Show initialization message
+        _display->setTextSize(1);
+        _display->setCursor(0, 0);
+        _display->println(F("UWB TAG Initializing..."));
+        _display->display();
+    }
+    
+    // Leave the message up before configuration starts
+    delay(1000);
+#endif
+    
+    // Configure UWB module
+    configureUWBModule();
+}
+
+void UWBTAG::configureUWBModule() {
+    Serial2.println("AT");
+    
+    sendCommand("AT?", 500, false);
+    sendCommand("AT+RESTORE", 1000, false);
+    
+    // Configure as tag (role=0)
+    String command;
+    unsigned long wait;
+    for (int step = 0; moduleConfigStep(step, _tagNumber, false, _totalTags, command, wait); step++) {
+        sendCommand(command, wait, false);
+    }
+    
+#if UWB_ENABLE_DISPLAY
+    if (_displayInitialized) {
+        _display->clearDisplay();
+        _display->setCursor(0, 0);
+        _display->print(F("TAG "));
+        _display->println(_tagNumber);
+        _display->setCursor(0, 15);
+        _display->println(F("Ready for data"));
+        _display->display();
+    }
+#endif
+    
+    delay(1000);
+}
+
+void UWBTAG::setTagNumber(int tagNum) {
+    _tagNumber = tagNum;
+}
+
+void UWBTAG::refreshRate(unsigned long rate) {
+    _refreshRate = rate;
+    _scheduler.setPeriod(TASK_RANGING, rate);
+    _scheduler.setPeriod(TASK_DISPLAY, rate);
+}
+
+void UWBTAG::totalTags(int count) {
+    _totalTags = count;
+}
+
+void UWBTAG::anchor0(float x, float y) {
+    _anchorPositions[0][0] = x;
+    _anchorPositions[0][1] = y;
+    _solver.setAnchor(0, x, y);
+}
+
+void UWBTAG::anchor1(float x, float y) {
+    _anchorPositions[1][0] = x;
+    _anchorPositions[1][1] = y;
+    _solver.setAnchor(1, x, y);
+}
+
+void UWBTAG::anchor2(float x, float y) {
+    _anchorPositions[2][0] = x;
+    _anchorPositions[2][1] = y;
+    _solver.setAnchor(2, x, y);
+}
+
+void UWBTAG::anchor3(float x, float y) {
+    _anchorPositions[3][0] = x;
+    _anchorPositions[3][1] = y;
+    _solver.setAnchor(3, x, y);
+}
+
+void UWBTAG::update() {
+    // Run whatever is due: ingest and solve every call, ranging and
+    // display at the refresh rate, telemetry when enabled
+    _scheduler.run();
+}
+
+void UWBTAG::taskIngest(void* self) {
+    ((UWBTAG*)self)->readUWBData();
+}
+
+void UWBTAG::taskSolve(void* self) {
+    UWBTAG* tag = (UWBTAG*)self;
+    if (tag->_solvePending) {
+        tag->_solvePending = false;
+        tag->calculatePosition();
+    }
+}
+
+void UWBTAG::taskRanging(void* self) {
+    ((UWBTAG*)self)->sendCommandAsync("AT+RANGE");
+}
+
+#if UWB_ENABLE_DISPLAY
+void UWBTAG::taskDisplay(void* self) {
+    ((UWBTAG*)self)->updateDisplay();
+}
+#endif
+
+void UWBTAG::taskTelemetry(void* self) {
+    UWBTAG* node = (UWBTAG*)self;
+    node->printLinkStats(Serial);
+    if (node->_scheduler.isEnabled(TASK_MEMORY)) {
+        node->printMemoryStats(Serial);
+    }
+}
+
+void UWBTAG::taskMemory(void* self) {
+    UWBTAG* node = (UWBTAG*)self;
+    uwbMemorySample(node->_memorySample, millis());
+    node->_memorySampled = true;
+}
+
+void UWBTAG::taskUpload(void* self) {
+    UWBTAG* tag = (UWBTAG*)self;
+    if (tag->_uploadPending) {
+        tag->_uploadPending = false;
+        tag->uploadFix();
+    }
+}
+
+void UWBTAG::taskSync(void* self) {
+    ((UWBTAG*)self)->requestClockSync();
+}
+
+void UWBTAG::readUWBData() {
+    while (Serial2.available() > 0) {
+        char c = Serial2.read();
+        
+        if (c == '\r') {
+            continue;
+        } else if (c == '\n') {
+            if (_response.length() > 0) {
+                // Check if it's range data or position data
+                if (_response.startsWith("AT+RANGE=")) {
+                    parseRangeData(_response);
+                }
+                else if (_response.startsWith("AT+RDATA=")) {
+                    if (_response.indexOf("ANCHORS:") >= 0) {
+                        parseAnchorData(_response);
+                    } else {
+                        // Sync first, so this frame's fix times use it
+                        parseClockSync(_response);
+#if UWB_ENABLE_MULTITAG
+                        parsePositionData(_response);
+#endif
+                    }
+                }
+                _response = "";
+            }
+        } else {
+            _response += c;
+        }
+    }
+}
+
+void UWBTAG::parseRangeData(const String& data) {
+    // Only the anchors flagged in the report's mask are converted
+    UWBRangeReport report;
+    if (!parseRangeReport(data.c_str(), report) || !report.hasRanges) {
+        return;
+    }
+    unsigned long now = millis();
+    _linkStats.update(report.hasSeq, report.seq, now);
+    
+    // onRange sees the module's ranges, the solver the filtered ones
+    float distances[4] = {report.range[0], report.range[1], report.range[2], report.range[3]};
+    if (_rangeFilter != nullptr) {
+        report.mask = _rangeFilter->apply(0, report.range, report.mask, now);
+    }
+    
+    // Keep every anchor for zone solves; the distance variables cover 0-3
+    for (int i = 0; i < UWBSolver::MAX_ANCHORS; i++) {
+        _ranges[i] = report.range[i];
+    }
+    _rangeMask = report.mask;
+    _rangeReportSeq = report.seq;
+    
+    // Update distance variables
+    a0Distance = report.range[0];
+    a1Distance = report.range[1];
+    a2Distance = report.range[2];
+    a3Distance = report.range[3];
+    
+    if (_onRange != nullptr) {
+        _onRange(_tagNumber, distances, 4, ++_rangeSeq, now);
+    }
+    
+    // Solve in the scheduler's solve task, right after this ingest pass
+    _solvePending = true;
+}
+
+void UWBTAG::parseAnchorData(const String& data) {
+    // Surveyed layout from the Position Server: ANCHORS:id:x:y:...
+    UWBAnchorPosition anchors[UWBSolver::MAX_ANCHORS];
+    int count = parseAnchorList(data.c_str(), anchors, UWBSolver::MAX_ANCHORS);
+    for (int i = 0; i < count; i++) {
+        int id = anchors[i].id;
+        if (id < 0 || id >= UWBSolver::MAX_ANCHORS) continue;
+        if (id < 4) {
+            _anchorPositions[id][0] = anchors[i].x;
+            _anchorPositions[id][1] = anchors[i].y;
+        }
+        _solver.setAnchor(id, anchors[i].x, anchors[i].y);
+    }
+}
+
+#if UWB_ENABLE_MULTITAG
+void UWBTAG::parsePositionData(const String& data) {
+    // Parse position data from Position Server anchor
+    // Format: AT+RDATA=1,0,timestamp,length,ALLPOS@time:tag1:x1:y1:age1:tag2:x2:y2:age2:...
+    // Sharded servers send ALLPOS#<shard>@time:... and each frame only
+    // replaces the tags previously received from that shard. Frames without
+    // @time carry no ages (see UWBProtocol.h). Parsed in place, without
+    // substrings, so a frame costs no heap.
+    
+    // Look for "ALLPOS" in the response
+    const char* header = strstr(data.c_str(), "ALLPOS");
+    if (header == nullptr) {
+        return;
+    }
+    const char* headerEnd = strchr(header, ':');
+    char next = header[6];
+    if (headerEnd == nullptr || (next != '#' && next != '@' && next != ':')) {
+        return;
+    }
+    
+    int shard = (next == '#') ? atoi(header + 7) : 0;
+    const char* at = strchr(header, '@');
+    bool timed = (at != nullptr && at < headerEnd);
+    unsigned long serverTime = timed ? strtoul(at + 1, nullptr, 10) : 0;
+    bool synced = timed && _clockSync.isSynced() && shard == _syncShard;
+    const char* posData = headerEnd + 1; // Skip "ALLPOS...:"
+    unsigned long now = millis();
+    
+    // Tags from this shard must reappear in this frame to stay active
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getShard() == shard) {
+            _otherTags[i].setSeen(false);
+        }
+    }
+    
+    // Parse tag positions: tag, x, y and (timed frames) age
+    int fields = timed ? 4 : 3;
+    while (*posData != '\0') {
+        float values[4];
+        int field = 0;
+        bool lastTag = false;
+        for (; field < fields; field++) {
+            // The last tag in the list has no trailing colon
+            values[field] = strtof(posData, nullptr);
+            const char* colon = strchr(posData, ':');
+            lastTag = (colon == nullptr);
+            if (lastTag) break;
+            posData = colon + 1;
+        }
+        if (field < fields - 1) break; // Truncated entry
+        
+        // When the fix was measured on our clock: through the shared
+        // timebase when this shard's server answers our sync requests,
+        // otherwise from the arrival time (late by the frame's transit)
+        unsigned long fixTime = now;
+        if (timed) {
+            unsigned long age = (unsigned long)values[3];
+            fixTime = synced ? _clockSync.toLocal(serverTime - age) : now - age;
+            if ((long)(fixTime - now) > 0) fixTime = now;
+        }
+        
+        // Store this tag (if it's not us)
+        int tagID = (int)values[0];
+        if (tagID != _tagNumber) {
+            updateOtherTag(tagID, values[1], values[2], shard, fixTime);
+        }
+        
+        if (lastTag) break;
+    }
+    
+    // Tags from this shard missing from the frame are lost and leave all their zones
+    _activeOtherTagCount = 0;
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        OtherTag& tag = _otherTags[i];
+        if (tag.isActive() && tag.getShard() == shard && !tag.isSeen()) {
+            _tagLock.writeBegin();
+            tag.setActive(false);
+            _tagLock.writeEnd();
+            _zones.removeTag(i);
+            if (_onTagLost != nullptr) _onTagLost(tag.getID(), millis());
+        }
+        if (tag.isActive()) {
+            _activeOtherTagCount++;
+        }
+    }
+}
+#endif
+
+void UWBTAG::calculatePosition() {
+    unsigned long now = millis();
+    bool warmStart = _rawFixValid && (now - _rawFixTime < UWBMotionFilter::RESET_GAP);
+    float rawX = _rawFixX;
+    float rawY = _rawFixY;
+    uint8_t rejected = 0;
+    
+    if (_site.zoneCount() > 0) {
+        // Nearest anchors of the active zone; the zone is also the bounds check
+        if (!_site.solve(_solver, _ranges, _rangeMask, nullptr, rawX, rawY, warmStart)) {
+            return;
+        }
+        rejected = _site.getRejected();
+    } else {
+        // Check if we have valid distances from all 4 anchors
+        if (a0Distance <= 0 || a1Distance <= 0 || a2Distance <= 0 || a3Distance <= 0) {
+            return;
+        }
+        
+        // Average of the four anchor triangles (0,1,2 / 0,1,3 / 0,2,3 / 1,2,3),
+        // optionally refined starting from the previous raw fix
+        float distances[UWBSolver::MAX_ANCHORS] = {a0Distance, a1Distance, a2Distance, a3Distance, 0, 0, 0, 0};
+        if (!_solver.solve(distances, 0x0F, nullptr, rawX, rawY, warmStart, &rejected)) {
+            return;
+        }
+        
+        // Filter out values outside boundaries
+        if (rawX < 0 || rawY < 0 || rawX > _anchorPositions[2][0] || rawY > _anchorPositions[1][1]) {
+            return;
+        }
+    }
+    _rejectedAnchors = rejected;
+    while (rejected != 0) {
+        _anchorRejections[__builtin_ctz(rejected)]++;
+        rejected &= rejected - 1;
+    }
+    // Readers of positionX/Y (copyTags, getTagPosition) retry across this
+    _tagLock.writeBegin();
+    _rawFixX = rawX;
+    _rawFixY = rawY;
+    _rawFixTime = now;
+    _rawFixValid = true;
+    
+    // Add to position history
+    _positionXHistory[_positionHistoryIndex] = rawX;
+    _positionYHistory[_positionHistoryIndex] = rawY;
+    _positionHistoryIndex = (_positionHistoryIndex + 1) % _positionHistoryLength;
+    if (_positionHistoryIndex == 0) {
+        _positionHistoryFilled = true;
+    }
+    
+    // Update final position
+    switch (_filterType) {
+        case FILTER_AVERAGE: {
+            int count = _positionHistoryFilled ? _positionHistoryLength : _positionHistoryIndex;
+            float sumX = 0.0, sumY = 0.0;
+            for (int i = 0; i < count; i++) {
+                sumX += _positionXHistory[i];
+                sumY += _positionYHistory[i];
+            }
+            positionX = sumX / count;
+            positionY = sumY / count;
+            _selfMotion.update(positionX, positionY, now, 1.0, PREDICTOR_BETA);
+            break;
+        }
+        case FILTER_ALPHA_BETA:
+            // The tracker is both the filter and the predictor
+            _selfMotion.update(rawX, rawY, now, _filterAlpha, _filterBeta);
+            positionX = _selfMotion.x;
+            positionY = _selfMotion.y;
+            break;
+        default:
+            positionX = rawX;
+            positionY = rawY;
+            _selfMotion.update(positionX, positionY, now, 1.0, PREDICTOR_BETA);
+            break;
+    }
+    positionTime = now;
+    _tagLock.writeEnd();
+    
+    if (_trajectories != nullptr) {
+        _trajectories->add(_trajectories->getTracks() - 1, positionX, positionY, now);
+    }
+    
+    // Queue the fix for upload, with how well it fits the ranges
+    if (_scheduler.isEnabled(TASK_UPLOAD)) {
+        _fixSeq = _rangeReportSeq;
+        uint8_t used = _rangeMask & ~_rejectedAnchors;
+        _fixResidual = (_site.zoneCount() > 0) ? _site.residual(_ranges, used, rawX, rawY)
+                                               : _solver.residual(_ranges, used, rawX, rawY);
+        _uploadPending = true;
+    }
+    
+    // Evaluate zones for our own position
+    _zones.update(_zones.getTags() - 1, _tagNumber, positionX, positionY);
+    
+    if (_onPosition != nullptr) {
+        _onPosition(_tagNumber, positionX, positionY, ++_positionSeq, millis());
+    }
+}
+
+#if UWB_ENABLE_DISPLAY
+void UWBTAG::updateDisplay() {
+    if (!_displayInitialized) {
+        return;
+    }
+    
+    _display->clearDisplay();
+    
+    // Display header
+    _display->setTextSize(1);
+    _display->setCursor(0, 0);
+    _display->print(F("TAG "));
+    _display->println(_tagNumber);
+    _display->drawLine(0, 9, 128, 9, SSD1306_WHITE);
+    
+    // Display distances to A0 and A1
+    _display->setCursor(0, 12);
+    _display->print(F("A0: "));
+    if (a0Distance > 0) {
+        _display->print(a0Distance, 1);
+    } else {
+        _display->print(F("---"));
+    }
+    
+    _display->setCursor(64, 12);
+    _display->print(F("A1: "));
+    if (a1Distance > 0) {
+        _display->print(a1Distance, 1);
+    } else {
+        _display->print(F("---"));
+    }
+    
+    // Display distances to A2 and A3
+    _display->setCursor(0, 24);
+    _display->print(F("A2: "));
+    if (a2Distance > 0) {
+        _display->print(a2Distance, 1);
+    } else {
+        _display->print(F("---"));
+    }
+    
+    _display->setCursor(64, 24);
+    _display->print(F("A3: "));
+    if (a3Distance > 0) {
+        _display->print(a3Distance, 1);
+    } else {
+        _display->print(F("---"));
+    }
+    
+    // Display divider
+    _display->drawLine(0, 35, 128, 35, SSD1306_WHITE);
+    
+    // Display position
+    _display->setCursor(0, 40);
+    _display->println(F("POSITION:"));
+    
+    _display->setCursor(0, 50);
+    _display->print(F("X: "));
+    _display->print(positionX, 1);
+    
+    _display->setCursor(64, 50);
+    _display->print(F("Y: "));
+    _display->print(positionY, 1);
+    
+    _display->display();
+}
+#endif
+
+float UWBTAG::getTagDistance(int tagID) {
+    if (tagID == _tagNumber) {
+        return 0.0; // Distance to self is 0
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    // Find the tag
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID && _otherTags[i].isActive()) {
+            // Calculate distance using Euclidean formula
+            float dx = _otherTags[i].getX() - positionX;
+            float dy = _otherTags[i].getY() - positionY;
+            return std::sqrt(dx * dx + dy * dy);
+        }
+    }
+#endif
+    
+    return -1.0; // Tag not found or not active
+}
+
+float UWBTAG::getTagX(int tagID) {
+    if (tagID == _tagNumber) {
+        return positionX; // Our own position
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID && _otherTags[i].isActive()) {
+            return _otherTags[i].getX();
+        }
+    }
+#endif
+    
+    return 0.0; // Tag not found
+}
+
+float UWBTAG::getTagY(int tagID) {
+    if (tagID == _tagNumber) {
+        return positionY; // Our own position
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID && _otherTags[i].isActive()) {
+            return _otherTags[i].getY();
+        }
+    }
+#endif
+    
+    return 0.0; // Tag not found
+}
+
+bool UWBTAG::isTagActive(int tagID) {
+    if (tagID == _tagNumber) {
+        return true; // We are always active (for ourselves)
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID && _otherTags[i].isActive()) {
+            return true;
+        }
+    }
+#endif
+    
+    return false;
+}
+
+int UWBTAG::getActiveTagCount() {
+#if UWB_ENABLE_MULTITAG
+    return _activeOtherTagCount + 1; // +1 for ourselves
+#else
+    return 1;
+#endif
+}
+
+int UWBTAG::copyTags(UWBTagPosition* out, int maxCount) {
+    if (out == nullptr || maxCount <= 0) return 0;
+    
+    // One pass over the table, repeated only if update() wrote meanwhile
+    unsigned long now = millis();
+    int count;
+    uint32_t seq;
+    do {
+        seq = _tagLock.readBegin();
+        out[0].tagID = _tagNumber;
+        out[0].x = positionX;
+        out[0].y = positionY;
+        out[0].age = now - positionTime;
+        out[0].valid = _rawFixValid;
+        count = 1;
+#if UWB_ENABLE_MULTITAG
+        for (int i = 0; i < MAX_OTHER_TAGS && count < maxCount; i++) {
+            const OtherTag& tag = _otherTags[i];
+            if (!tag.isActive()) continue;
+            out[count].tagID = tag.getID();
+            out[count].x = tag.getX();
+            out[count].y = tag.getY();
+            out[count].age = now - tag.getLastSeen(now);
+            out[count].valid = true;
+            count++;
+        }
+#endif
+    } while (_tagLock.readRetry(seq));
+    return count;
+}
+
+bool UWBTAG::getTagPosition(int tagID, UWBTagPosition& out) {
+    unsigned long now = millis();
+    bool found;
+    uint32_t seq;
+    do {
+        seq = _tagLock.readBegin();
+        found = false;
+        if (tagID == _tagNumber) {
+            out.tagID = tagID;
+            out.x = positionX;
+            out.y = positionY;
+            out.age = now - positionTime;
+            out.valid = _rawFixValid;
+            found = true;
+        }
+#if UWB_ENABLE_MULTITAG
+        for (int i = 0; i < MAX_OTHER_TAGS && !found; i++) {
+            const OtherTag& tag = _otherTags[i];
+            if (tag.getID() == tagID && tag.isActive()) {
+                out.tagID = tagID;
+                out.x = tag.getX();
+                out.y = tag.getY();
+                out.age = now - tag.getLastSeen(now);
+                out.valid = true;
+                found = true;
+            }
+        }
+#endif
+    } while (_tagLock.readRetry(seq));
+    return found;
+}
+
+int UWBTAG::addCircleZone(float x, float y, float radius) {
+    return _zones.addCircle(x, y, radius);
+}
+
+int UWBTAG::addRectZone(float x1, float y1, float x2, float y2) {
+    return _zones.addRect(x1, y1, x2, y2);
+}
+
+int UWBTAG::addPolygonZone(const float* xs, const float* ys, int count) {
+    return _zones.addPolygon(xs, ys, count);
+}
+
+bool UWBTAG::removeZone(int zoneID) {
+    return _zones.removeZone(zoneID);
+}
+
+void UWBTAG::zoneHysteresis(float cm) {
+    _zones.setHysteresis(cm);
+}
+
+void UWBTAG::onZoneEnter(ZoneCallback callback) {
+    _zones.onEnter(callback);
+}
+
+void UWBTAG::onZoneExit(ZoneCallback callback) {
+    _zones.onExit(callback);
+}
+
+bool UWBTAG::isInZone(int zoneID) {
+    return _zones.isInside(_tagNumber, zoneID);
+}
+
+bool UWBTAG::isTagInZone(int tagID, int zoneID) {
+    return _zones.isInside(tagID, zoneID);
+}
+
+void UWBTAG::positionFilter(PositionFilter type, int length) {
+    if (length < 1) length = 1;
+    if (length > MAX_POSITION_HISTORY) length = MAX_POSITION_HISTORY;
+    
+    _filterType = type;
+    _positionHistoryLength = (type == FILTER_AVERAGE) ? length : 1;
+    _positionHistoryIndex = 0;
+    _positionHistoryFilled = false;
+    _selfMotion.reset();
+}
+
+void UWBTAG::filterGains(float alpha, float beta) {
+    _filterAlpha = alpha;
+    _filterBeta = beta;
+}
+
+int UWBTAG::addAnchorZone(float x1, float y1, float x2, float y2) {
+    return _site.addZone(x1, y1, x2, y2);
+}
+
+bool UWBTAG::zoneAnchor(int zone, int anchorID, float x, float y) {
+    return _site.addAnchor(zone, anchorID, x, y);
+}
+
+void UWBTAG::activeAnchors(int count) {
+    _site.setActiveSetSize(count);
+}
+
+int UWBTAG::getAnchorZone() {
+    return _site.getActiveZone();
+}
+
+void UWBTAG::setAnchorZone(int zone) {
+    _site.setActiveZone(zone);
+}
+
+void UWBTAG::solverIterations(int maxIterations, float tolerance) {
+    _solver.setRefinement(maxIterations, tolerance);
+}
+
+void UWBTAG::outlierRejection(float thresholdCm, int maxRejects) {
+    _solver.setOutlierRejection(thresholdCm, maxRejects);
+}
+
+uint8_t UWBTAG::getRejectedAnchors() {
+    return _rejectedAnchors;
+}
+
+uint32_t UWBTAG::getAnchorRejections(int anchorID) {
+    if (anchorID < 0 || anchorID >= UWBSolver::MAX_ANCHORS) return 0;
+    return _anchorRejections[anchorID];
+}
+
+void UWBTAG::predictionHorizon(unsigned long ms) {
+    _predictionHorizon = ms;
+}
+
+bool UWBTAG::getPredictedPosition(int tagID, float& x, float& y) {
+    return getPredictedPosition(tagID, millis(), x, y);
+}
+
+bool UWBTAG::getPredictedPosition(int tagID, unsigned long atTime, float& x, float& y) {
+    if (tagID == _tagNumber) {
+        return _selfMotion.predict(atTime, _predictionHorizon, x, y);
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID && _otherTags[i].isActive()) {
+            return _otherTags[i].predict(atTime, _predictionHorizon, x, y);
+        }
+    }
+#endif
+    
+    return false; // Tag not found
+}
+
+unsigned long UWBTAG::getTagTimestamp(int tagID) {
+    if (tagID == _tagNumber) {
+        return positionTime;
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID && _otherTags[i].isActive()) {
+            return _otherTags[i].getLastSeen(millis());
+        }
+    }
+#endif
+    
+    return 0; // Tag not found
+}
+
+UWBRangeFilter& UWBTAG::rangeFilterState() {
+    if (_rangeFilter == nullptr) {
+        _rangeFilter = new UWBRangeFilter(1);
+    }
+    return *_rangeFilter;
+}
+
+void UWBTAG::rangeFilter(RangeFilterType type, int window) {
+    rangeFilterState().setType(type, window);
+}
+
+void UWBTAG::rangeGate(float maxSpeed) {
+    rangeFilterState().setGate(maxSpeed);
+}
+
+void UWBTAG::rangeSmoothing(float alpha) {
+    rangeFilterState().setSmoothing(alpha);
+}
+
+void UWBTAG::trajectoryHistory(int fixesPerTag) {
+    if (_trajectories != nullptr) {
+        delete _trajectories;
+        _trajectories = nullptr;
+    }
+    if (fixesPerTag > 0) {
+#if UWB_ENABLE_MULTITAG
+        _trajectories = new UWBTrajectoryStore(MAX_OTHER_TAGS + 1, fixesPerTag);
+#else
+        _trajectories = new UWBTrajectoryStore(1, fixesPerTag);
+#endif
+    }
+}
+
+int UWBTAG::trajectoryTrack(int tagID) {
+    if (_trajectories == nullptr) return -1;
+    if (tagID == _tagNumber) {
+        return _trajectories->getTracks() - 1;
+    }
+    
+#if UWB_ENABLE_MULTITAG
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID && _otherTags[i].isActive()) {
+            return i;
+        }
+    }
+#endif
+    
+    return -1; // Tag not found
+}
+
+bool UWBTAG::getTagVelocity(int tagID, float& vx, float& vy) {
+    int track = trajectoryTrack(tagID);
+    return track >= 0 && _trajectories->getVelocity(track, vx, vy);
+}
+
+float UWBTAG::getTagSpeed(int tagID) {
+    int track = trajectoryTrack(tagID);
+    return (track >= 0) ? _trajectories->getSpeed(track) : 0.0;
+}
+
+float UWBTAG::getTagHeading(int tagID) {
+    int track = trajectoryTrack(tagID);
+    return (track >= 0) ? _trajectories->getHeading(track) : -1.0;
+}
+
+bool UWBTAG::getTagPositionAt(int tagID, unsigned long atTime, float& x, float& y) {
+    int track = trajectoryTrack(tagID);
+    return track >= 0 && _trajectories->getPositionAt(track, atTime, x, y);
+}
+
+int UWBTAG::copyTrajectory(int tagID, UWBTrajectoryPoint* out, int maxCount) {
+    int track = trajectoryTrack(tagID);
+    return (track >= 0) ? _trajectories->copy(track, out, maxCount) : 0;
+}
+
+void UWBTAG::uploadFixes(unsigned long intervalMs) {
+    _scheduler.setEnabled(TASK_UPLOAD, intervalMs > 0);
+    if (intervalMs > 0) {
+        _scheduler.setPeriod(TASK_UPLOAD, intervalMs);
+    }
+}
+
+void UWBTAG::uploadFix() {
+    // Latest (filtered) fix as a FIX frame; the server stores it as is
+    UWBFixReport fix;
+    fix.tagID = _tagNumber;
+    fix.seq = _fixSeq;
+    fix.x = positionX;
+    fix.y = positionY;
+    fix.residual = _fixResidual;
+    fix.age = millis() - positionTime;
+    fix.hasSent = _syncPending;
+    fix.sent = millis();
+    _syncPending = false;
+    if (_clockSync.isSynced()) {
+        fix.age += _clockSync.getDelay() / 2; // Time on the way to the server
+    }
+    
+    char payload[64];
+    int length = formatFixReport(fix, payload, sizeof(payload));
+    if (length > 0) {
+        sendDataAsync(payload, length);
+    }
+}
+
+void UWBTAG::clockSync(unsigned long intervalMs) {
+    _scheduler.setEnabled(TASK_SYNC, intervalMs > 0);
+    if (intervalMs > 0) {
+        _scheduler.setPeriod(TASK_SYNC, intervalMs);
+    } else {
+        _clockSync.reset();
+        _syncPending = false;
+    }
+}
+
+void UWBTAG::requestClockSync() {
+    // A fix about to be uploaded carries the request for free
+    if (_scheduler.isEnabled(TASK_UPLOAD) && _uploadPending) {
+        _syncPending = true;
+        return;
+    }
+    UWBSyncRequest request;
+    request.tagID = _tagNumber;
+    request.sent = millis();
+    
+    char payload[32];
+    int length = formatSyncRequest(request, payload, sizeof(payload));
+    if (length > 0) {
+        sendDataAsync(payload, length);
+    }
+}
+
+void UWBTAG::parseClockSync(const String& data) {
+    // ALLPOS[#shard]@<time>!<tid>,<sent>,<received>...: answers a request
+    int posStart = data.indexOf("ALLPOS");
+    if (posStart < 0 || !_scheduler.isEnabled(TASK_SYNC)) {
+        return;
+    }
+    const char* header = data.c_str() + posStart;
+    const char* at = strchr(header, '@');
+    const char* colon = strchr(header, ':');
+    UWBSyncEcho echo;
+    if (at == nullptr || colon == nullptr || at > colon || !parseSyncEcho(header, _tagNumber, echo)) {
+        return;
+    }
+    uint32_t serverTime = strtoul(at + 1, nullptr, 10);
+    if (_clockSync.addSample(echo.sent, echo.received, serverTime, millis())) {
+        _syncShard = (header[6] == '#') ? atoi(header + 7) : 0;
+    }
+}
+
+bool UWBTAG::isClockSynced() {
+    return _clockSync.isSynced();
+}
+
+double UWBTAG::getClockOffset() {
+    return _clockSync.getOffset(millis());
+}
+
+float UWBTAG::getClockDrift() {
+    return _clockSync.getDrift();
+}
+
+unsigned long UWBTAG::getClockDelay() {
+    return _clockSync.getDelay();
+}
+
+unsigned long UWBTAG::serverTime() {
+    return _clockSync.toServer(millis());
+}
+
+unsigned long UWBTAG::serverTime(unsigned long localTime) {
+    return _clockSync.toServer(localTime);
+}
+
+unsigned long UWBTAG::localTime(unsigned long serverTime) {
+    return _clockSync.toLocal(serverTime);
+}
+
+const UWBLinkStats& UWBTAG::getLinkStats() {
+    return _linkStats;
+}
+
+float UWBTAG::getLinkQuality() {
+    return _linkStats.getQuality();
+}
+
+void UWBTAG::printLinkStats(Print& out) {
+    printLinkLine(out, _tagNumber, _linkStats, millis());
+}
+
+void UWBTAG::onRange(RangeCallback callback) {
+    _onRange = callback;
+}
+
+void UWBTAG::onPosition(PositionCallback callback) {
+    _onPosition = callback;
+}
+
+void UWBTAG::onTagSeen(TagEventCallback callback) {
+    _onTagSeen = callback;
+}
+
+void UWBTAG::onTagLost(TagEventCallback callback) {
+    _onTagLost = callback;
+}
+
+void UWBTAG::sendCommandAsync(const char* command) {
+    // Runtime commands must not block update(); the module's reply lines
+    // arrive through readUWBData() like any other output
+    Serial2.println(command);
+}
+
+void UWBTAG::sendDataAsync(const char* payload, int length) {
+    char header[20];
+    snprintf(header, sizeof(header), "AT+DATA=%d,", length);
+    Serial2.print(header);
+    Serial2.println(payload);
+}
+
+void UWBTAG::taskPeriod(UWBTask task, unsigned long ms) {
+    _scheduler.setPeriod(task, ms);
+}
+
+void UWBTAG::taskBudget(UWBTask task, unsigned long ms) {
+    _scheduler.setBudget(task, ms);
+}
+
+void UWBTAG::enableTask(UWBTask task, bool enabled) {
+    _scheduler.setEnabled(task, enabled);
+}
+
+uint32_t UWBTAG::getTaskOverruns(UWBTask task) {
+    return _scheduler.getOverruns(task);
+}
+
+void UWBTAG::printTaskStats(Print& out) {
+    printTaskLines(out, _scheduler);
+}
+
+void UWBTAG::memoryTelemetry(unsigned long periodMs) {
+    if (periodMs > 0) {
+        _scheduler.setPeriod(TASK_MEMORY, periodMs);
+    }
+    _scheduler.setEnabled(TASK_MEMORY, periodMs > 0);
+}
+
+bool UWBTAG::getMemoryStats(UWBMemorySample& out) {
+    if (!_memorySampled) return false;
+    out = _memorySample;
+    return true;
+}
+
+void UWBTAG::getAllocations(int bucket, UWBAllocCount& out) {
+    uwbAllocGet(bucket, out);
+}
+
+void UWBTAG::printMemoryStats(Print& out) {
+    printMemoryLines(out, _scheduler, _memorySampled ? &_memorySample : nullptr);
+}
+
+String UWBTAG::sendCommand(String command, int timeout, bool debug) {
+    String response = "";
+    
+    Serial2.println(command);
+    
+    long int time = millis();
+    
+    while ((time + timeout) > millis()) {
+        while (Serial2.available()) {
+            char c = Serial2.read();
+            response += c;
+        }
+    }
+    
+    return response;
+}
+
+#if UWB_ENABLE_MULTITAG
+OtherTag* UWBTAG::getOtherTag(int tagID) {
+    // First, look for existing tag (a slot keeps its ID and motion track
+    // between broadcasts, even while marked inactive)
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == tagID) {
+            return &_otherTags[i];
+        }
+    }
+    
+    // If not found, find an empty slot (unused first, then any inactive one)
+    int slot = -1;
+    for (int i = 0; i < MAX_OTHER_TAGS; i++) {
+        if (_otherTags[i].getID() == -1) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && !_otherTags[i].isActive()) {
+            slot = i;
+        }
+    }
+    
+    if (slot >= 0) {
+        // Caller marks it active once its position is stored
+        _otherTags[slot].reset();
+        _otherTags[slot].setID(tagID);
+        if (_trajectories != nullptr) _trajectories->clear(slot);
+        return &_otherTags[slot];
+    }
+    
+    return nullptr; // No available slots
+}
+
+void UWBTAG::updateOtherTag(int tagID, float x, float y, int shard, unsigned long fixTime) {
+    _tagLock.writeBegin();
+    OtherTag* tag = getOtherTag(tagID);
+    if (tag == nullptr) {
+        _tagLock.writeEnd();
+        return;
+    }
+    
+    // A server repeats a tag's last fix until it has a new one: that only
+    // keeps the tag active
+    unsigned long now = millis();
+    bool wasActive = tag->isActive();
+    bool newFix = !wasActive || (long)(fixTime - tag->getLastSeen(now)) >= (long)SAME_FIX_WINDOW;
+    if (newFix) {
+        tag->track(x, y, fixTime, PREDICTOR_BETA);
+    }
+    tag->setActive(true);
+    tag->setShard(shard);
+    tag->setSeen(true);
+    _tagLock.writeEnd();
+    if (!newFix) {
+        return;
+    }
+    
+    if (_trajectories != nullptr) {
+        _trajectories->add(tag - _otherTags, x, y, fixTime);
+    }
+    _zones.update(tag - _otherTags, tagID, x, y);
+    
+    if (!wasActive && _onTagSeen != nullptr) {
+        _onTagSeen(tagID, now);
+    }
+    if (_onPosition != nullptr) {
+        _onPosition(tagID, x, y, ++_positionSeq, now);
+    }
+}
+#endif
+
+// ==============================
+// UWBAnchor Implementation
+// ==============================
+
+UWBAnchor::UWBAnchor(AnchorType type) : _zones(MAX_TRACKED_TAGS), _scheduler(micros) {
+    // Set anchor type
+    anchorType = type;
+    
+    // Initialize variables
+    _anchorNumber = 0;
+    _anchorPosition[0] = 0.0;
+    _anchorPosition[1] = 0.0;
+    _refreshRate = 100;
+    _totalTags = 10;
+#if UWB_ENABLE_DISPLAY
+    _displayInitialized = false;
+    _newData = false;
+#endif
+    _response = "";
+    _response.reserve(RESPONSE_RESERVE); // Cleared per line, never shrinks: no heap per line
+    trackedTagCount = 0;
+    _onRange = nullptr;
+    _onPosition = nullptr;
+    _onTagSeen = nullptr;
+    _onTagLost = nullptr;
+    _rangeSeq = 0;
+    _positionSeq = 0;
+    _shardIndex = 0;
+    _shardCount = 1;
+    _shardFirstTag = -1;
+    _shardLastTag = -1;
+#if UWB_ENABLE_POSITION_SERVER
+    _lastBroadcastCount = 0;
+    _syncEchoCount = 0;
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        _anchorRejections[i] = 0;
+    }
+    _dirtyCount = 0;
+    _solveInterval = 0;
+    _solveDue = 0;
+#endif
+    _loggerFormat = LOG_TEXT;
+    _logQueue = nullptr;
+    _reportedLogDrops = 0;
+    _trajectories = nullptr;
+    _rangeFilter = nullptr;
+    _lastLogFlush = 0;
+    _streamPositions = false;
+    _survey = nullptr;
+    _surveyCollecting = false;
+    _surveyTurn = SURVEY_IDLE;
+    _surveyStep = 0;
+    _surveyNext = 0;
+    _surveyDuration = 0;
+    _surveyEnd = 0;
+    
+    // Initialize tracked tags
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        _trackedTags[i].reset();
+    }
+    
+    // Scheduled subsystems: id, name, task, period (ms, 0 = every update), priority, budget (ms)
+    _scheduler.setTask(TASK_INGEST, "ingest", taskIngest, this, 0, 255, 5);
+    _scheduler.setTask(TASK_LOGGER, "logger", taskLogger, this, 0, 180, 2);
+#if UWB_ENABLE_POSITION_SERVER
+    _scheduler.setTask(TASK_SOLVE, "solve", taskSolve, this, 0, 200, 5);
+    _scheduler.setTask(TASK_BROADCAST, "broadcast", taskBroadcast, this, 500, 100, 10);
+#endif
+    _scheduler.setTask(TASK_EXPIRY, "expiry", taskExpiry, this, 1000, 80, 2);
+#if UWB_ENABLE_DISPLAY
+    _scheduler.setTask(TASK_DISPLAY, "display", taskDisplay, this, _refreshRate, 50, 40);
+#endif
+    _scheduler.setTask(TASK_TELEMETRY, "telemetry", taskTelemetry, this, 1000, 10, 5);
+    _scheduler.setEnabled(TASK_TELEMETRY, false);
+    _scheduler.setTask(TASK_SURVEY, "survey", taskSurvey, this, 100, 150, 2);
+    _scheduler.setEnabled(TASK_SURVEY, false);
+    _scheduler.setTask(TASK_MEMORY, "memory", taskMemory, this, 1000, 5, 1);
+    _scheduler.setEnabled(TASK_MEMORY, false);
+    _memorySampled = false;
+    
+    // Initialize hardware immediately
+    initializeHardware();
+}
+
+UWBAnchor::~UWBAnchor() {
+#if UWB_ENABLE_DISPLAY
+    // Free allocated memory for display
+    if (_display != nullptr) {
+        delete _display;
+        _display = nullptr;
+    }
+#endif
+    
+    // Free binary logger queue
+    if (_logQueue != nullptr) {
+        delete _logQueue;
+        _logQueue = nullptr;
+    }
+    
+    if (_trajectories != nullptr) {
+        delete _trajectories;
+        _trajectories = nullptr;
+    }
+    if (_rangeFilter != nullptr) {
+        delete _rangeFilter;
+        _rangeFilter = nullptr;
+    }
+    
+    if (_survey != nullptr) {
+        delete _survey;
+        _survey = nullptr;
+    }
+}
+
+void UWBAnchor::initializeHardware() {
+    // Initialize reset pin
+    pinMode(RESET_PIN, OUTPUT);
+    digitalWrite(RESET_PIN, HIGH);
+    
+    // Initialize Serial2 for UWB communication
+    Serial2.begin(115200, SERIAL_8N1, IO_RXD2, IO_TXD2);
+    
+#if UWB_ENABLE_DISPLAY
+    // Initialize I2C
+    Wire.begin(I2C_SDA, I2C_SCL);
+#endif
+    
+    delay(500);
+    
+#if UWB_ENABLE_DISPLAY
+    // Initialize display
+    _display = new Adafruit_SSD1306(128, 64, &Wire, -1);
+    if (_display->begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+        _displayInitialized = true;
+        _display->clearDisplay();
+        _display->setTextColor(SSD1306_WHITE);
+        
+        // Show initialization message
+        _display->setTextSize(1);
+        _display->setCursor(0, 0);
+        _display->println(F("UWB ANCHOR"));
+        _display->setCursor(0, 15);
+        _display->print(F("Type: "));
+        switch(anchorType) {
+            case GENERAL:
+                _display->println(F("GENERAL"));
+                break;
+            case DATA_LOGGER:
+                _display->println(F("DATA_LOGGER"));
+                break;
+            case POSITION_SERVER:
+                _display->println(F("POS_SERVER"));
+                break;
+        }
+        _display->setCursor(0, 30);
+        _display->println(F("Initializing..."));
+        _display->display();
+    }
+    
+    // Leave the message up before configuration starts
+    delay(1000);
+#endif
+    
+    // Configure UWB module
+    configureUWBModule();
+}
+
+void UWBAnchor::configureUWBModule() {
+    Serial2.println("AT");
+    
+    sendCommand("AT?", 500, false);
+    sendCommand("AT+RESTORE", 1000, false);
+    
+    // Configure as anchor (role=1)
+    String command;
+    unsigned long wait;
+    for (int step = 0; moduleConfigStep(step, _anchorNumber, true, _totalTags, command, wait); step++) {
+        sendCommand(command, wait, false);
+    }
+    
+#if UWB_ENABLE_DISPLAY
+    if (_displayInitialized) {
+        _display->clearDisplay();
+        _display->setTextSize(1);
+        _display->setCursor(0, 0);
+        _display->print(F("ANCHOR "));
+        _display->println(_anchorNumber);
+        _display->setCursor(0, 15);
+        _display->print(F("Type: "));
+        switch(anchorType) {
+            case GENERAL:
+                _display->println(F("GENERAL"));
+                break;
+            case DATA_LOGGER:
+                _display->println(F("DATA_LOGGER"));
+                break;
+            case POSITION_SERVER:
+                _display->println(F("POS_SERVER"));
+                break;
+        }
+        _display->setCursor(0, 30);
+        _display->println(F("Ready"));
+        _display->display();
+    }
+#endif
+    
+    delay(1000);
+}
+
+void UWBAnchor::setAnchorNumber(int anchorNum) {
+    _anchorNumber = anchorNum;
+}
+
+void UWBAnchor::setAnchorPosition(float x, float y) {
+    _anchorPosition[0] = x;
+    _anchorPosition[1] = y;
+}
+
+void UWBAnchor::refreshRate(unsigned long rate) {
+    _refreshRate = rate;
+    _scheduler.setPeriod(TASK_DISPLAY, rate);
+}
+
+void UWBAnchor::totalTags(int count) {
+    _totalTags = count;
+}
+
+void UWBAnchor::setOtherAnchor(int anchorID, float x, float y) {
+#if UWB_ENABLE_POSITION_SERVER
+    _solver.setAnchor(anchorID, x, y);
+#else
+    (void)anchorID; (void)x; (void)y;
+#endif
+}
+
+void UWBAnchor::setShard(int shardIndex, int shardCount) {
+    if (shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount) {
+        return;
+    }
+    _shardIndex = shardIndex;
+    _shardCount = shardCount;
+    _shardFirstTag = -1;
+    _shardLastTag = -1;
+}
+
+void UWBAnchor::setShardRange(int firstTagID, int lastTagID) {
+    setShardRange(0, firstTagID, lastTagID);
+}
+
+void UWBAnchor::setShardRange(int shardIndex, int firstTagID, int lastTagID) {
+    if (shardIndex < 0 || firstTagID < 0 || lastTagID < firstTagID) {
+        return;
+    }
+    _shardIndex = shardIndex;
+    _shardCount = 1;
+    _shardFirstTag = firstTagID;
+    _shardLastTag = lastTagID;
+}
+
+bool UWBAnchor::ownsTag(int tagID) {
+    if (_shardFirstTag >= 0) {
+        return tagID >= _shardFirstTag && tagID <= _shardLastTag;
+    }
+    // Non-negative bucket for negative IDs too, so every tag has a shard
+    return ((tagID % _shardCount) + _shardCount) % _shardCount == _shardIndex;
+}
+
+void UWBAnchor::update() {
+    // Run whatever is due: ingest every call, broadcast (Position Server),
+    // logger drain (Data Logger), tag expiry and display at their own periods
+    _scheduler.run();
+}
+
+void UWBAnchor::taskIngest(void* self) {
+    ((UWBAnchor*)self)->readUWBData();
+}
+
+#if UWB_ENABLE_POSITION_SERVER
+void UWBAnchor::taskSolve(void* self) {
+    UWBAnchor* anchor = (UWBAnchor*)self;
+    if (anchor->_dirtyCount > 0 && (long)(millis() - anchor->_solveDue) >= 0) {
+        anchor->solveDirtyTags(false);
+    }
+}
+
+void UWBAnchor::taskBroadcast(void* self) {
+    UWBAnchor* anchor = (UWBAnchor*)self;
+    if (anchor->anchorType == POSITION_SERVER) {
+        anchor->processPositionServer();
+    }
+}
+#endif
+
+void UWBAnchor::taskSurvey(void* self) {
+    // Survey turn: wait, reconfigure the module as a tag, range, then
+    // restore the anchor. Each configuration command goes out on its own
+    // run once the previous one has settled, so update() never blocks.
+    // AT+SAVE keeps the tag role in module flash during the turn; a reset
+    // meanwhile reruns initializeHardware(), which restores the anchor.
+    UWBAnchor* anchor = (UWBAnchor*)self;
+    unsigned long now = millis();
+    if (anchor->_surveyTurn == SURVEY_IDLE || (long)(now - anchor->_surveyNext) < 0) {
+        return;
+    }
+    
+    if (anchor->_surveyTurn == SURVEY_WAITING) {
+        anchor->_surveyTurn = SURVEY_TO_TAG;
+        anchor->_surveyStep = 0;
+    }
+    
+    if (anchor->_surveyTurn == SURVEY_RANGING) {
+        if ((long)(now - anchor->_surveyEnd) < 0) {
+            anchor->sendCommandAsync("AT+RANGE");
+            return;
+        }
+        anchor->_surveyTurn = SURVEY_TO_ANCHOR;
+        anchor->_surveyStep = 0;
+    }
+    
+    // Switching roles: tag ID is the anchor number, so reports name the
+    // anchor they range from
+    bool toAnchor = (anchor->_surveyTurn == SURVEY_TO_ANCHOR);
+    String command;
+    unsigned long wait;
+    if (moduleConfigStep(anchor->_surveyStep, anchor->_anchorNumber, toAnchor, anchor->_totalTags,
+                         command, wait)) {
+        anchor->sendCommandAsync(command.c_str());
+        anchor->_surveyStep++;
+        anchor->_surveyNext = now + wait;
+    } else if (toAnchor) {
+        anchor->_surveyTurn = SURVEY_IDLE;
+        anchor->_scheduler.setEnabled(TASK_SURVEY, false);
+    } else {
+        anchor->_surveyTurn = SURVEY_RANGING;
+        anchor->_surveyEnd = now + anchor->_surveyDuration;
+    }
+}
+
+void UWBAnchor::taskExpiry(void* self) {
+    ((UWBAnchor*)self)->expireTags();
+}
+
+#if UWB_ENABLE_DISPLAY
+void UWBAnchor::taskDisplay(void* self) {
+    ((UWBAnchor*)self)->updateDisplay();
+}
+#endif
+
+void UWBAnchor::taskTelemetry(void* self) {
+    UWBAnchor* node = (UWBAnchor*)self;
+    node->printLinkStats(Serial);
+    if (node->_scheduler.isEnabled(TASK_MEMORY)) {
+        node->printMemoryStats(Serial);
+    }
+}
+
+void UWBAnchor::taskMemory(void* self) {
+    UWBAnchor* node = (UWBAnchor*)self;
+    uwbMemorySample(node->_memorySample, millis());
+    node->_memorySampled = true;
+}
+
+void UWBAnchor::taskLogger(void* self) {
+    UWBAnchor* anchor = (UWBAnchor*)self;
+    if (anchor->anchorType == DATA_LOGGER || anchor->_streamPositions) {
+        anchor->processDataLogger();
+    }
+}
+
+void UWBAnchor::readUWBData() {
+    while (Serial2.available() > 0) {
+        char c = Serial2.read();
+        
+        if (c == '\r') {
+            continue;
+        } else if (c == '\n') {
+            if (_response.length() > 0) {
+                if (_response.startsWith("AT+RANGE=")) {
+                    parseRangeData(_response);
+                }
+#if UWB_ENABLE_POSITION_SERVER
+                else if (_response.startsWith("AT+RDATA=")) {
+                    if (_response.indexOf("SYNC:") >= 0) {
+                        parseSyncData(_response);
+                    } else {
+                        parseFixData(_response);
+                    }
+                }
+#endif
+                _response = "";
+            }
+        } else {
+            _response += c;
+        }
+    }
+}
+
+void UWBAnchor::parseRangeData(const String& data) {
+    // Look for "AT+RANGE=" in the response
+    if (!data.startsWith("AT+RANGE=")) {
+        return;
+    }
+#if UWB_ENABLE_DISPLAY
+    _newData = true;
+#endif
+    
+    // Extract tag ID and range data (distances to anchors 0-7)
+    UWBRangeReport report;
+    if (!parseRangeReport(data.c_str(), report)) {
+        return;
+    }
+    unsigned long now = millis();
+    int tagID = report.tagID;
+    
+    // Survey reports are anchor-to-anchor ranges, not tags. During our own
+    // turn they go to USB as well so host tools (uwb_survey) can use them,
+    // as range records when USB carries binary frames.
+    if (_surveyTurn == SURVEY_RANGING) {
+        if (binaryOutput()) {
+            if (report.hasRanges) {
+                logRangeRecord(tagID, report.range, ++_rangeSeq, now);
+            }
+        } else {
+            Serial.println(data);
+        }
+        return;
+    }
+    if (_surveyTurn == SURVEY_TO_TAG || _surveyTurn == SURVEY_TO_ANCHOR) {
+        return; // Module is between roles
+    }
+    if (_surveyCollecting) {
+        _survey->addReport(tagID, report);
+        return;
+    }
+    
+    // Sharded Position Servers leave other shards' tags alone
+    bool tracked = (anchorType != POSITION_SERVER) || ownsTag(tagID);
+    
+    // Update tag last seen and its link counters
+    if (tracked) {
+        TrackedTag* tag = getTrackedTag(tagID);
+        if (tag != nullptr) {
+            tag->setLastSeen(now);
+            _linkStats[tag - _trackedTags].update(report.hasSeq, report.seq, now);
+        }
+    }
+    
+    uint32_t seq = report.hasRanges ? ++_rangeSeq : _rangeSeq;
+    if (report.hasRanges && _onRange != nullptr) {
+        _onRange(tagID, report.range, 8, seq, now);
+    }
+    
+#if UWB_ENABLE_POSITION_SERVER
+    // For Position Server, store range data and calculate position
+    if (anchorType == POSITION_SERVER && tracked && report.hasRanges) {
+        TrackedTag* tag = getTrackedTag(tagID);
+        if (tag != nullptr) {
+            if (_rangeFilter != nullptr) {
+                report.mask = _rangeFilter->apply(tag - _trackedTags, report.range, report.mask, now);
+            }
+            
+            // Reports that arrive before the tag is solved are merged:
+            // newer ranges replace older ones, anchors missing from the
+            // newer report keep their pending range
+            bool merge = tag->isDirty();
+            for (int i = 0; i < 8; i++) {
+                if (!merge || (report.mask & (1 << i))) {
+                    tag->setDistance(i, report.range[i]);
+                    tag->setRssi(i, report.rssi[i]);
+                }
+            }
+            tag->setMask(merge ? (tag->getMask() | report.mask) : report.mask);
+            tag->setSeq(report.hasSeq ? report.seq : seq);
+            
+            // Mark as active and queue a solve (TASK_SOLVE), unless the
+            // tag uploads its own fixes
+            _tagLock.writeBegin();
+            tag->setActive(true);
+            _tagLock.writeEnd();
+            if (!merge && (!tag->isFixUploaded() || tag->getFixAge(now) >= FIX_UPLOAD_TIMEOUT)) {
+                tag->setDirty(true);
+                _dirtyCount++;
+                _solveDue = now;
+            }
+        }
+    }
+#endif
+    
+    // For Data Logger, forward to Serial
+    if (anchorType == DATA_LOGGER) {
+        if (_loggerFormat == LOG_BINARY) {
+            if (report.hasRanges) {
+                logRangeRecord(tagID, report.range, seq, now);
+            }
+        } else {
+            Serial.println(data);
+        }
+    }
+}
+
+void UWBAnchor::processDataLogger() {
+    // Data Logger - forward all range data to Serial
+    // Text lines are printed in parseRangeData, binary frames are drained here
+    if (_logQueue != nullptr) {
+        flushLogQueue();
+    }
+}
+
+bool UWBAnchor::binaryOutput() {
+    return (anchorType == DATA_LOGGER && _loggerFormat == LOG_BINARY) || _streamPositions;
+}
+
+void UWBAnchor::logRangeRecord(int tagID, const float* distances, uint32_t seq, unsigned long timestamp) {
+    UWBRangeRecord record;
+    record.timestamp = timestamp;
+    record.tagID = tagID;
+    record.seq = seq;
+    record.anchorID = _anchorNumber;
+    record.mask = 0;
+    
+    // Whole cm, only anchors that answered
+    for (int i = 0; i < 8; i++) {
+        record.range[i] = 0;
+        if (distances[i] > 0) {
+            float cm = distances[i] + 0.5;
+            record.range[i] = (cm > 65535.0) ? 65535 : (uint16_t)cm;
+            record.mask |= (1 << i);
+        }
+    }
+    
+    uint8_t payload[UWB_MAX_FRAME];
+    int length = encodeRangeRecord(record, payload);
+    _logQueue->push(FRAME_RANGE, payload, length); // Counted as a drop if full
+}
+
+void UWBAnchor::streamPosition(int tagID, float x, float y, uint32_t seq, float residual,
+                               uint8_t mask, uint8_t flags, unsigned long timestamp) {
+    UWBPositionRecord record;
+    record.timestamp = timestamp;
+    record.tagID = tagID;
+    record.seq = seq;
+    record.x = (int32_t)(x < 0 ? x * 10.0 - 0.5 : x * 10.0 + 0.5); // cm to mm
+    record.y = (int32_t)(y < 0 ? y * 10.0 - 0.5 : y * 10.0 + 0.5);
+    record.residual = (residual < 0 || residual >= 6553.4) ? 0xFFFF : (uint16_t)(residual * 10.0 + 0.5);
+    record.mask = mask;
+    record.flags = flags;
+    
+    uint8_t payload[POSITION_RECORD_SIZE];
+    int length = encodePositionRecord(record, payload);
+    _logQueue->push(FRAME_POSITION, payload, length); // Counted as a drop if full
+}
+
+void UWBAnchor::flushLogQueue() {
+    // Let small frames accumulate into one larger USB write
+    if (_logQueue->used() < LOG_BATCH_BYTES && millis() - _lastLogFlush < LOG_FLUSH_INTERVAL) {
+        return;
+    }
+    _lastLogFlush = millis();
+    
+    // Tell the host how many frames it missed
+    uint32_t dropped = _logQueue->getDropped();
+    if (dropped != _reportedLogDrops) {
+        uint8_t payload[4] = {
+            (uint8_t)(dropped & 0xFF), (uint8_t)((dropped >> 8) & 0xFF),
+            (uint8_t)((dropped >> 16) & 0xFF), (uint8_t)((dropped >> 24) & 0xFF)
+        };
+        if (_logQueue->push(FRAME_DROPS, payload, 4)) {
+            _reportedLogDrops = dropped;
+        }
+    }
+    
+    // Write only what the port can take without blocking
+    while (_logQueue->used() > 0) {
+        int room = Serial.availableForWrite();
+        if (room <= 0) break;
+        
+        const uint8_t* data;
+        int length = _logQueue->peek(&data);
+        if (length > room) length = room;
+        
+        int written = Serial.write(data, length);
+        _logQueue->consume(written);
+        if (written < length) break;
+    }
+}
+
+#if UWB_ENABLE_POSITION_SERVER
+void UWBAnchor::processPositionServer() {
+    // Position Server - the scheduler calls this every broadcast period
+    // (500 ms by default); tags still waiting for a solve go out fresh
+    solveDirtyTags(true);
+    broadcastAllPositions();
+}
+
+void UWBAnchor::solveDirtyTags(bool all) {
+    // Each tag is solved at most once per solve interval, however many
+    // reports arrived in between (all: ignore the interval)
+    unsigned long now = millis();
+    unsigned long wait = _solveInterval;
+    for (int i = 0; i < MAX_TRACKED_TAGS && _dirtyCount > 0; i++) {
+        TrackedTag& tag = _trackedTags[i];
+        if (!tag.isDirty()) continue;
+        if (!all && tag.isPositionValid() && tag.getFixAge(now) < _solveInterval) {
+            // Not due yet; skip the scan until the first waiting tag is
+            unsigned long remaining = _solveInterval - tag.getFixAge(now);
+            if (remaining < wait) wait = remaining;
+            continue;
+        }
+        tag.setDirty(false);
+        _dirtyCount--;
+        calculateTagPosition(i);
+    }
+    _solveDue = now + wait;
+}
+#endif
+
+void UWBAnchor::expireTags() {
+    // Clean up inactive tags
+    unsigned long now = millis();
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].isActive() && 
+            (_trackedTags[i].getAge(now) > 5000)) { // 5 second timeout
+            _tagLock.writeBegin();
+            _trackedTags[i].setActive(false);
+            _trackedTags[i].setPositionValid(false);
+            _trackedTags[i].setFixUploaded(false);
+#if UWB_ENABLE_POSITION_SERVER
+            if (_trackedTags[i].isDirty()) {
+                _trackedTags[i].setDirty(false);
+                _dirtyCount--;
+            }
+#endif
+            trackedTagCount--;
+            _tagLock.writeEnd();
+            _zones.removeTag(i);
+            if (_onTagLost != nullptr) _onTagLost(_trackedTags[i].getID(), now);
+        } else if (_trackedTags[i].isActive() && _trackedTags[i].isPositionValid() &&
+                   _trackedTags[i].getFixAge(now) > MAX_FIX_AGE) {
+            // Still ranging but no fix for a long time (too few anchors):
+            // drop the fix before a compact stamp wraps and makes it look fresh
+            _tagLock.writeBegin();
+            _trackedTags[i].setPositionValid(false);
+            _trackedTags[i].setFixUploaded(false);
+            _tagLock.writeEnd();
+        }
+    }
+}
+
+TrackedTag* UWBAnchor::getTrackedTag(int tagID) {
+    // First, look for existing tag
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            return &_trackedTags[i];
+        }
+    }
+    
+    // If not found, find an empty slot
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (!_trackedTags[i].isActive()) {
+            _tagLock.writeBegin();
+            _trackedTags[i].setID(tagID);
+            _trackedTags[i].setActive(true);
+            _trackedTags[i].setPositionValid(false);
+            _trackedTags[i].setFixUploaded(false);
+            trackedTagCount++;
+            _tagLock.writeEnd();
+            _linkStats[i].reset();
+            if (_trajectories != nullptr) _trajectories->clear(i);
+            if (_rangeFilter != nullptr) _rangeFilter->clear(i);
+            if (_onTagSeen != nullptr) _onTagSeen(tagID, millis());
+            return &_trackedTags[i];
+        }
+    }
+    
+    return nullptr; // No available slots
+}
+
+#if UWB_ENABLE_POSITION_SERVER
+void UWBAnchor::parseFixData(const String& data) {
+    // A tag that solves its own position: store the fix as is, no solve
+    UWBFixReport fix;
+    if (anchorType != POSITION_SERVER || !parseFixReport(data.c_str(), fix) || !ownsTag(fix.tagID)) {
+        return;
+    }
+    if (fix.hasSent) {
+        queueSyncEcho(fix.tagID, fix.sent, millis());
+    }
+    if (fix.residual > UWBSolver::MAX_RESIDUAL) {
+        return; // Poor fit, keep the previous position
+    }
+    TrackedTag* tag = getTrackedTag(fix.tagID);
+    if (tag == nullptr) return;
+    
+    unsigned long now = millis();
+    if (tag->isFixUploaded() && tag->isPositionValid() && tag->getFixAge(now) < fix.age) {
+        return; // Older than the fix already stored
+    }
+    
+    _tagLock.writeBegin();
+    tag->setPosition(fix.x, fix.y);
+    tag->setPositionValid(true);
+    tag->setFixTime(now - fix.age);
+    tag->setFixUploaded(true);
+    tag->setLastSeen(now);
+    _tagLock.writeEnd();
+    if (tag->isDirty()) {
+        tag->setDirty(false); // The tag's own fix replaces the pending solve
+        _dirtyCount--;
+    }
+    
+    if (_trajectories != nullptr) {
+        _trajectories->add(tag - _trackedTags, fix.x, fix.y, now - fix.age);
+    }
+    if (_streamPositions) {
+        streamPosition(fix.tagID, fix.x, fix.y, fix.seq, fix.residual, 0, POSITION_UPLOADED, now - fix.age);
+    }
+    _zones.update(tag - _trackedTags, fix.tagID, fix.x, fix.y);
+    
+    if (_onPosition != nullptr) {
+        _onPosition(fix.tagID, fix.x, fix.y, ++_positionSeq, now);
+    }
+}
+
+void UWBAnchor::parseSyncData(const String& data) {
+    UWBSyncRequest request;
+    if (anchorType != POSITION_SERVER || !parseSyncRequest(data.c_str(), request) || !ownsTag(request.tagID)) {
+        return;
+    }
+    queueSyncEcho(request.tagID, request.sent, millis());
+}
+
+void UWBAnchor::queueSyncEcho(int tagID, uint32_t sent, unsigned long received) {
+    // One echo per tag (the newest request); a request that finds the
+    // queue full is dropped and the tag asks again next interval
+    int slot = 0;
+    while (slot < _syncEchoCount && _syncEchoes[slot].tagID != tagID) {
+        slot++;
+    }
+    if (slot == MAX_SYNC_ECHOES) {
+        return;
+    }
+    if (slot == _syncEchoCount) {
+        _syncEchoCount++;
+    }
+    _syncEchoes[slot].tagID = tagID;
+    _syncEchoes[slot].sent = sent;
+    _syncEchoes[slot].received = received;
+}
+
+void UWBAnchor::calculateTagPosition(int tagIndex) {
+    if (tagIndex < 0 || tagIndex >= MAX_TRACKED_TAGS) return;
+    
+    TrackedTag* tag = &_trackedTags[tagIndex];
+    
+    float distances[8];
+    float weights[8];
+    tag->getDistances(distances);
+    for (int i = 0; i < 8; i++) {
+        weights[i] = UWBSolver::rssiWeight(tag->getRssi(i));
+    }
+    
+    // Missing anchors are skipped via the mask, weak links count less.
+    // A recent fix seeds the optional iterative refinement.
+    unsigned long now = millis();
+    bool warmStart = tag->isPositionValid() && tag->getFixAge(now) < UWBMotionFilter::RESET_GAP;
+    float x = tag->getX();
+    float y = tag->getY();
+    uint8_t rejected;
+    if (_solver.solve(distances, tag->getMask(), weights, x, y, warmStart, &rejected)) {
+        _tagLock.writeBegin();
+        tag->setPosition(x, y);
+        tag->setPositionValid(true);
+        tag->setFixTime(now);
+        _tagLock.writeEnd();
+        
+        if (_trajectories != nullptr) {
+            _trajectories->add(tagIndex, x, y, now);
+        }
+        
+        uint8_t used = tag->getMask() & ~rejected;
+        while (rejected != 0) {
+            _anchorRejections[__builtin_ctz(rejected)]++;
+            rejected &= rejected - 1;
+        }
+        if (_streamPositions) {
+            streamPosition(tag->getID(), x, y, tag->getSeq(), _solver.residual(distances, used, x, y),
+                           used, 0, now);
+        }
+        
+        // Evaluate zones only now that this tag has a new fix
+        _zones.update(tagIndex, tag->getID(), x, y);
+        
+        if (_onPosition != nullptr) {
+            _onPosition(tag->getID(), x, y, ++_positionSeq, now);
+        }
+    }
+}
+
+void UWBAnchor::broadcastAllPositions() {
+    // Sharded servers tag the frame so tags only replace this shard's entries
+    char* frame = _broadcastFrame;
+    int size = sizeof(_broadcastFrame);
+    int n = snprintf(frame, size, "ALLPOS");
+    if (_shardCount > 1 || _shardFirstTag >= 0) {
+        n += snprintf(frame + n, size - n, "#%d", _shardIndex);
+    }
+    
+    // Our clock, then the answers to clock sync requests (UWBProtocol.h)
+    unsigned long now = millis();
+    n += snprintf(frame + n, size - n, "@%lu", now);
+    for (int i = 0; i < _syncEchoCount; i++) {
+        n += formatSyncEcho(_syncEchoes[i], frame + n, size - n);
+    }
+    int activeCount = 0;
+    
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].isActive() && _trackedTags[i].isPositionValid()) {
+            // The header's ':' doubles as the first separator
+            int length = snprintf(frame + n, size - n, ":%d:%.1f:%.1f:%lu", _trackedTags[i].getID(),
+                                  _trackedTags[i].getX(), _trackedTags[i].getY(),
+                                  _trackedTags[i].getFixAge(now));
+            if (length <= 0 || length >= size - n) {
+                frame[n] = '\0'; // Out of range coordinates; the frame ends here
+                break;
+            }
+            n += length;
+            activeCount++;
+        }
+    }
+    if (activeCount == 0) {
+        n += snprintf(frame + n, size - n, ":");
+    }
+    
+    // Send one empty frame after the last tag goes so tags can drop it
+    if (activeCount > 0 || _lastBroadcastCount > 0 || _syncEchoCount > 0) {
+        sendDataAsync(frame, n);
+    }
+    _lastBroadcastCount = activeCount;
+    _syncEchoCount = 0;
+}
+#endif
+
+#if UWB_ENABLE_DISPLAY
+void UWBAnchor::updateDisplay() {
+    if (!_displayInitialized) return;
+    
+    _display->clearDisplay();
+    
+    // Display header
+    _display->setTextSize(1);
+    _display->setCursor(0, 0);
+    _display->print(F("ANCHOR "));
+    _display->println(_anchorNumber);
+    _display->drawLine(0, 9, 128, 9, SSD1306_WHITE);
+    
+    // Display type
+    _display->setCursor(0, 12);
+    _display->print(F("Type: "));
+    switch(anchorType) {
+        case GENERAL:
+            _display->println(F("GENERAL"));
+            break;
+        case DATA_LOGGER:
+            _display->println(F("DATA_LOG"));
+            break;
+        case POSITION_SERVER:
+            _display->println(F("POS_SVR"));
+            break;
+    }
+    
+    // Display position
+    _display->setCursor(0, 24);
+    _display->print(F("Pos: ("));
+    _display->print(_anchorPosition[0], 0);
+    _display->print(F(","));
+    _display->print(_anchorPosition[1], 0);
+    _display->println(F(")"));
+    
+    // Type-specific display
+    if (anchorType == POSITION_SERVER) {
+        _display->setCursor(0, 36);
+        _display->print(F("Tags: "));
+        _display->println(trackedTagCount);
+        
+        // Show some active tags
+        _display->setCursor(0, 48);
+        int shown = 0;
+        for (int i = 0; i < MAX_TRACKED_TAGS && shown < 3; i++) {
+            if (_trackedTags[i].isActive()) {
+                if (shown > 0) _display->print(F(" "));
+                _display->print(F("T"));
+                _display->print(_trackedTags[i].getID());
+                shown++;
+            }
+        }
+    } else {
+        _display->setCursor(0, 36);
+        _display->println(F("Listening..."));
+        
+        if (_newData) {
+            _display->setCursor(0, 48);
+            _display->println(F("Data received"));
+            _newData = false;
+        }
+    }
+    
+    _display->display();
+}
+#endif
+
+// Data access methods
+int UWBAnchor::getTrackedTagCount() {
+    return trackedTagCount;
+}
+
+float UWBAnchor::getTagX(int tagID) {
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive() && _trackedTags[i].isPositionValid()) {
+            return _trackedTags[i].getX();
+        }
+    }
+    return 0.0;
+}
+
+float UWBAnchor::getTagY(int tagID) {
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive() && _trackedTags[i].isPositionValid()) {
+            return _trackedTags[i].getY();
+        }
+    }
+    return 0.0;
+}
+
+bool UWBAnchor::isTagActive(int tagID) {
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned long UWBAnchor::getTagLastSeen(int tagID) {
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            unsigned long now = millis();
+            return now - _trackedTags[i].getAge(now);
+        }
+    }
+    return 0;
+}
+
+// Snapshot entry for an active tracked tag; before its first fix the age
+// is time since the tag was last heard
+static void copyTrackedTag(const TrackedTag& tag, unsigned long now, UWBTagPosition& out) {
+    out.tagID = tag.getID();
+    out.x = tag.getX();
+    out.y = tag.getY();
+    out.valid = tag.isPositionValid();
+    out.age = out.valid ? tag.getFixAge(now) : tag.getAge(now);
+}
+
+int UWBAnchor::copyTags(UWBTagPosition* out, int maxCount) {
+    if (out == nullptr || maxCount <= 0) return 0;
+    
+    // One pass over the table, repeated only if update() wrote meanwhile
+    unsigned long now = millis();
+    int count;
+    uint32_t seq;
+    do {
+        seq = _tagLock.readBegin();
+        count = 0;
+        for (int i = 0; i < MAX_TRACKED_TAGS && count < maxCount; i++) {
+            if (_trackedTags[i].isActive()) {
+                copyTrackedTag(_trackedTags[i], now, out[count++]);
+            }
+        }
+    } while (_tagLock.readRetry(seq));
+    return count;
+}
+
+bool UWBAnchor::getTagPosition(int tagID, UWBTagPosition& out) {
+    unsigned long now = millis();
+    bool found;
+    uint32_t seq;
+    do {
+        seq = _tagLock.readBegin();
+        found = false;
+        for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+            if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+                copyTrackedTag(_trackedTags[i], now, out);
+                found = true;
+                break;
+            }
+        }
+    } while (_tagLock.readRetry(seq));
+    return found;
+}
+
+uint32_t UWBAnchor::getTagSeq(int tagID) {
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            return _trackedTags[i].getSeq();
+        }
+    }
+    return 0;
+}
+
+float UWBAnchor::getTagRssi(int tagID, int anchorID) {
+    if (anchorID < 0 || anchorID >= MAX_ANCHORS) return 0.0;
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            return _trackedTags[i].getRssi(anchorID);
+        }
+    }
+    return 0.0;
+}
+
+UWBRangeFilter& UWBAnchor::rangeFilterState() {
+    if (_rangeFilter == nullptr) {
+        _rangeFilter = new UWBRangeFilter(MAX_TRACKED_TAGS);
+    }
+    return *_rangeFilter;
+}
+
+void UWBAnchor::rangeFilter(RangeFilterType type, int window) {
+    rangeFilterState().setType(type, window);
+}
+
+void UWBAnchor::rangeGate(float maxSpeed) {
+    rangeFilterState().setGate(maxSpeed);
+}
+
+void UWBAnchor::rangeSmoothing(float alpha) {
+    rangeFilterState().setSmoothing(alpha);
+}
+
+void UWBAnchor::trajectoryHistory(int fixesPerTag) {
+    if (_trajectories != nullptr) {
+        delete _trajectories;
+        _trajectories = nullptr;
+    }
+    if (fixesPerTag > 0) {
+        _trajectories = new UWBTrajectoryStore(MAX_TRACKED_TAGS, fixesPerTag);
+    }
+}
+
+int UWBAnchor::trajectoryTrack(int tagID) {
+    if (_trajectories == nullptr) return -1;
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool UWBAnchor::getTagVelocity(int tagID, float& vx, float& vy) {
+    int track = trajectoryTrack(tagID);
+    return track >= 0 && _trajectories->getVelocity(track, vx, vy);
+}
+
+float UWBAnchor::getTagSpeed(int tagID) {
+    int track = trajectoryTrack(tagID);
+    return (track >= 0) ? _trajectories->getSpeed(track) : 0.0;
+}
+
+float UWBAnchor::getTagHeading(int tagID) {
+    int track = trajectoryTrack(tagID);
+    return (track >= 0) ? _trajectories->getHeading(track) : -1.0;
+}
+
+bool UWBAnchor::getTagPositionAt(int tagID, unsigned long atTime, float& x, float& y) {
+    int track = trajectoryTrack(tagID);
+    return track >= 0 && _trajectories->getPositionAt(track, atTime, x, y);
+}
+
+int UWBAnchor::copyTrajectory(int tagID, UWBTrajectoryPoint* out, int maxCount) {
+    int track = trajectoryTrack(tagID);
+    return (track >= 0) ? _trajectories->copy(track, out, maxCount) : 0;
+}
+
+bool UWBAnchor::getLinkStats(int tagID, UWBLinkStats& stats) {
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            stats = _linkStats[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+float UWBAnchor::getLinkQuality(int tagID) {
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].getID() == tagID && _trackedTags[i].isActive()) {
+            return _linkStats[i].getQuality();
+        }
+    }
+    return 0.0;
+}
+
+void UWBAnchor::printLinkStats(Print& out) {
+    unsigned long now = millis();
+    for (int i = 0; i < MAX_TRACKED_TAGS; i++) {
+        if (_trackedTags[i].isActive()) {
+            printLinkLine(out, _trackedTags[i].getID(), _linkStats[i], now);
+        }
+    }
+}
+
+int UWBAnchor::addCircleZone(float x, float y, float radius) {
+    return _zones.addCircle(x, y, radius);
+}
+
+int UWBAnchor::addRectZone(float x1, float y1, float x2, float y2) {
+    return _zones.addRect(x1, y1, x2, y2);
+}
+
+int UWBAnchor::addPolygonZone(const float* xs, const float* ys, int count) {
+    return _zones.addPolygon(xs, ys, count);
+}
+
+bool UWBAnchor::removeZone(int zoneID) {
+    return _zones.removeZone(zoneID);
+}
+
+void UWBAnchor::zoneHysteresis(float cm) {
+    _zones.setHysteresis(cm);
+}
+
+void UWBAnchor::onZoneEnter(ZoneCallback callback) {
+    _zones.onEnter(callback);
+}
+
+void UWBAnchor::onZoneExit(ZoneCallback callback) {
+    _zones.onExit(callback);
+}
+
+bool UWBAnchor::isTagInZone(int tagID, int zoneID) {
+    return _zones.isInside(tagID, zoneID);
+}
+
+void UWBAnchor::solverIterations(int maxIterations, float tolerance) {
+#if UWB_ENABLE_POSITION_SERVER
+    _solver.setRefinement(maxIterations, tolerance);
+#else
+    (void)maxIterations; (void)tolerance;
+#endif
+}
+
+void UWBAnchor::outlierRejection(float thresholdCm, int maxRejects) {
+#if UWB_ENABLE_POSITION_SERVER
+    _solver.setOutlierRejection(thresholdCm, maxRejects);
+#else
+    (void)thresholdCm; (void)maxRejects;
+#endif
+}
+
+uint32_t UWBAnchor::getAnchorRejections(int anchorID) {
+#if UWB_ENABLE_POSITION_SERVER
+    if (anchorID < 0 || anchorID >= MAX_ANCHORS) return 0;
+    return _anchorRejections[anchorID];
+#else
+    (void)anchorID;
+    return 0;
+#endif
+}
+
+void UWBAnchor::solveInterval(unsigned long ms) {
+#if UWB_ENABLE_POSITION_SERVER
+    _solveInterval = ms;
+#else
+    (void)ms;
+#endif
+}
+
+void UWBAnchor::surveyTurn(unsigned long delayMs, unsigned long durationMs) {
+    if (_surveyTurn != SURVEY_IDLE) return;
+    _surveyNext = millis() + delayMs;
+    _surveyDuration = durationMs;
+    _surveyTurn = SURVEY_WAITING;
+    _scheduler.setEnabled(TASK_SURVEY, true);
+}
+
+bool UWBAnchor::isSurveyTurn() {
+    return _surveyTurn != SURVEY_IDLE;
+}
+
+void UWBAnchor::startSurvey() {
+    if (_survey == nullptr) {
+        _survey = new UWBSurvey();
+    }
+    _survey->reset();
+    _surveyCollecting = true;
+}
+
+bool UWBAnchor::finishSurvey() {
+    if (_survey == nullptr) return false;
+    _surveyCollecting = false;
+    if (!_survey->solve()) return false;
+    
+    // Use the layout here and send it to the tags
+    UWBAnchorPosition anchors[UWBSurvey::MAX_ANCHORS];
+    int count = 0;
+    for (int id = 0; id < UWBSurvey::MAX_ANCHORS; id++) {
+        float x, y;
+        if (!_survey->getPosition(id, x, y)) continue;
+        setOtherAnchor(id, x, y);
+        if (id == _anchorNumber) {
+            setAnchorPosition(x, y);
+        }
+        anchors[count].id = id;
+        anchors[count].x = x;
+        anchors[count].y = y;
+        count++;
+    }
+    
+    char payload[8 + UWBSurvey::MAX_ANCHORS * 24];
+    int length = formatAnchorList(anchors, count, payload, sizeof(payload));
+    if (length > 0) {
+        sendDataAsync(payload, length);
+    }
+    return true;
+}
+
+bool UWBAnchor::getSurveyAnchor(int anchorID, float& x, float& y) {
+    return _survey != nullptr && _survey->getPosition(anchorID, x, y);
+}
+
+float UWBAnchor::getSurveyResidual() {
+    return (_survey != nullptr) ? _survey->getResidual() : -1.0;
+}
+
+void UWBAnchor::printSurvey(Print& out) {
+    // SURVEY PAIR <a> <b> <mean cm> <count>, then SURVEY ANCHOR <id> <x> <y>
+    if (_survey == nullptr) return;
+    for (int a = 0; a < UWBSurvey::MAX_ANCHORS; a++) {
+        for (int b = a + 1; b < UWBSurvey::MAX_ANCHORS; b++) {
+            float cm;
+            if (!_survey->getRange(a, b, cm)) continue;
+            out.print("SURVEY PAIR ");
+            out.print(a);
+            out.print(' ');
+            out.print(b);
+            out.print(' ');
+            out.print(cm, 1);
+            out.print(' ');
+            out.println(_survey->getRangeCount(a, b));
+        }
+    }
+    for (int id = 0; id < UWBSurvey::MAX_ANCHORS; id++) {
+        float x, y;
+        if (!_survey->getPosition(id, x, y)) continue;
+        out.print("SURVEY ANCHOR ");
+        out.print(id);
+        out.print(' ');
+        out.print(x, 1);
+        out.print(' ');
+        out.println(y, 1);
+    }
+}
+
+void UWBAnchor::loggerFormat(LoggerFormat format) {
+    _loggerFormat = format;
+    if (format == LOG_BINARY && _logQueue == nullptr) {
+        _logQueue = new UWBFrameQueue();
+    }
+}
+
+void UWBAnchor::streamPositions(bool enabled) {
+    _streamPositions = enabled;
+    if (enabled && _logQueue == nullptr) {
+        _logQueue = new UWBFrameQueue();
+    }
+}
+
+uint32_t UWBAnchor::getLoggerDrops() {
+    return (_logQueue != nullptr) ? _logQueue->getDropped() : 0;
+}
+
+void UWBAnchor::onRange(RangeCallback callback) {
+    _onRange = callback;
+}
+
+void UWBAnchor::onPosition(PositionCallback callback) {
+    _onPosition = callback;
+}
+
+void UWBAnchor::onTagSeen(TagEventCallback callback) {
+    _onTagSeen = callback;
+}
+
+void UWBAnchor::onTagLost(TagEventCallback callback) {
+    _onTagLost = callback;
+}
+
+void UWBAnchor::sendCommandAsync(const char* command) {
+    // Runtime commands must not block update(); the module's reply lines
+    // arrive through readUWBData() like any other output
+    Serial2.println(command);
+}
+
+void UWBAnchor::sendDataAsync(const char* payload, int length) {
+    char header[20];
+    snprintf(header, sizeof(header), "AT+DATA=%d,", length);
+    Serial2.print(header);
+    Serial2.println(payload);
+}
+
+void UWBAnchor::taskPeriod(UWBTask task, unsigned long ms) {
+    _scheduler.setPeriod(task, ms);
+}
+
+void UWBAnchor::taskBudget(UWBTask task, unsigned long ms) {
+    _scheduler.setBudget(task, ms);
+}
+
+void UWBAnchor::enableTask(UWBTask task, bool enabled) {
+    _scheduler.setEnabled(task, enabled);
+}
+
+uint32_t UWBAnchor::getTaskOverruns(UWBTask task) {
+    return _scheduler.getOverruns(task);
+}
+
+void UWBAnchor::printTaskStats(Print& out) {
+    printTaskLines(out, _scheduler);
+}
+
+void UWBAnchor::memoryTelemetry(unsigned long periodMs) {
+    if (periodMs > 0) {
+        _scheduler.setPeriod(TASK_MEMORY, periodMs);
+    }
+    _scheduler.setEnabled(TASK_MEMORY, periodMs > 0);
+}
+
+bool UWBAnchor::getMemoryStats(UWBMemorySample& out) {
+    if (!_memorySampled) return false;
+    out = _memorySample;
+    return true;
+}
+
+void UWBAnchor::getAllocations(int bucket, UWBAllocCount& out) {
+    uwbAllocGet(bucket, out);
+}
+
+void UWBAnchor::printMemoryStats(Print& out) {
+    printMemoryLines(out, _scheduler, _memorySampled ? &_memorySample : nullptr);
+}
+
+String UWBAnchor::sendCommand(String command, int timeout, bool debug) {
+    String response = "";
+    
+    Serial2.println(command);
+    
+    long int time = millis();
+    
+    while ((time + timeout) > millis()) {
+        while (Serial2.available()) {
+            char c = Serial2.read();
+            response += c;
+        }
+    }
+    
+    return response;
+}
\ No newline at end of file
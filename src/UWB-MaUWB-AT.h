@@ -0,0 +1,599 @@
+#ifndef UWB_MAUWB_AT_H
+#define UWB_MAUWB_AT_H
+
+// Optional features (set to 0 with build flags, e.g. -DUWB_ENABLE_DISPLAY=0,
+// to strip them from headless or single-tag builds)
+#ifndef UWB_ENABLE_DISPLAY
+#define UWB_ENABLE_DISPLAY 1          // SSD1306 status display (Adafruit_SSD1306/GFX, Wire)
+#endif
+#ifndef UWB_ENABLE_MULTITAG
+#define UWB_ENABLE_MULTITAG 1         // UWBTAG keeps other tags from ALLPOS broadcasts
+#endif
+#ifndef UWB_ENABLE_POSITION_SERVER
+#define UWB_ENABLE_POSITION_SERVER 1  // UWBAnchor POSITION_SERVER solve and broadcast
+#endif
+
+#include <Arduino.h>
+#if UWB_ENABLE_DISPLAY
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+#endif
+#include "UWBZones.h"
+#include "UWBMotion.h"
+#include "UWBStream.h"
+#include "UWBSolver.h"
+#include "UWBProtocol.h"
+#include "UWBLinkStats.h"
+#include "UWBSite.h"
+#include "UWBScheduler.h"
+#include "UWBSeqLock.h"
+#include "UWBTrajectory.h"
+#include "UWBRangeFilter.h"
+#include "UWBClockSync.h"
+#include "UWBSurvey.h"
+#include "UWBMemory.h"
+#include "UWBTagRecords.h"   // TrackedTag and OtherTag (compact layout with UWB_COMPACT_TAGS)
+
+// Table sizes (override with build flags, e.g. -DUWB_MAX_OTHER_TAGS=128)
+#ifndef UWB_MAX_TRACKED_TAGS
+#define UWB_MAX_TRACKED_TAGS 64   // Tags one Position Server (or shard) tracks
+#endif
+#ifndef UWB_MAX_OTHER_TAGS
+#define UWB_MAX_OTHER_TAGS 64     // Other tags a UWBTAG keeps from ALLPOS broadcasts
+#endif
+
+// Forward declarations
+class UWBTAG;
+class UWBAnchor;
+
+// Anchor types enumeration
+enum AnchorType {
+    GENERAL,        // Basic anchor functionality
+    DATA_LOGGER,    // Forwards data to computer via serial
+    POSITION_SERVER // Calculates and broadcasts all tag positions
+};
+
+// Output format for DATA_LOGGER anchors
+enum LoggerFormat {
+    LOG_TEXT,       // Raw AT+RANGE lines, one println per report (default)
+    LOG_BINARY      // Framed binary records, batched and non-blocking (see UWBStream.h)
+};
+
+// Event callbacks. seq increments by one per event of that kind so gaps
+// and staleness can be detected; timestamp is millis() when the data arrived.
+typedef void (*RangeCallback)(int tagID, const float* distances, int count, uint32_t seq, unsigned long timestamp);
+typedef void (*PositionCallback)(int tagID, float x, float y, uint32_t seq, unsigned long timestamp);
+typedef void (*TagEventCallback)(int tagID, unsigned long timestamp);
+
+// One entry of a tag table snapshot (copyTags, getTagPosition)
+struct UWBTagPosition {
+    int tagID;
+    float x, y;             // cm
+    unsigned long age;      // ms since the position was measured (other tags: received)
+    bool valid;             // False until the tag's first fix
+};
+
+class UWBTAG {
+public:
+    // Constructor
+    UWBTAG();
+    
+    // Destructor
+    ~UWBTAG();
+    
+    // Configuration methods
+    void setTagNumber(int tagNum);
+    void refreshRate(unsigned long rate);
+    void totalTags(int count);
+    void anchor0(float x, float y);
+    void anchor1(float x, float y);
+    void anchor2(float x, float y);
+    void anchor3(float x, float y);
+    
+    // Large sites: rectangular anchor zones with up to 8 anchors each
+    // (module IDs 0-7, reusable across zones). Once a zone is added they
+    // replace anchor0-3.
+    int addAnchorZone(float x1, float y1, float x2, float y2);
+    bool zoneAnchor(int zone, int anchorID, float x, float y);
+    void activeAnchors(int count);               // Nearest anchors used per fix (3-8, default 4)
+    int getAnchorZone();                         // Zone of the last fix, -1 before the first
+    void setAnchorZone(int zone);                // Start zone (needed when zones reuse anchor IDs)
+    
+    // Main update method
+    void update();
+    
+    // Multi-tag methods (only our own tag with UWB_ENABLE_MULTITAG 0)
+    float getTagDistance(int tagID);
+    float getTagX(int tagID);
+    float getTagY(int tagID);
+    bool isTagActive(int tagID);
+    int getActiveTagCount();
+    
+    // Torn-free snapshots, safe from another task or core (see UWBSeqLock.h)
+    int copyTags(UWBTagPosition* out, int maxCount);      // Own tag first, then active others; returns count
+    bool getTagPosition(int tagID, UWBTagPosition& out);  // x, y and age from the same fix
+    
+    // Zone methods (own position and other tags from the Position Server)
+    int addCircleZone(float x, float y, float radius);
+    int addRectZone(float x1, float y1, float x2, float y2);
+    int addPolygonZone(const float* xs, const float* ys, int count);
+    bool removeZone(int zoneID);
+    void zoneHysteresis(float cm);
+    void onZoneEnter(ZoneCallback callback);
+    void onZoneExit(ZoneCallback callback);
+    bool isInZone(int zoneID);
+    bool isTagInZone(int tagID, int zoneID);
+    
+    // Event callbacks (called from update() as soon as data is parsed)
+    void onRange(RangeCallback callback);        // Own anchor distances
+    void onPosition(PositionCallback callback);  // Own fixes and other tags' positions
+    void onTagSeen(TagEventCallback callback);   // Other tag appears in a broadcast
+    void onTagLost(TagEventCallback callback);   // Other tag dropped from a broadcast
+    
+    // Filtering and prediction
+    void positionFilter(PositionFilter type, int length = 4);
+    void filterGains(float alpha, float beta);
+    void predictionHorizon(unsigned long ms);
+    void solverIterations(int maxIterations, float tolerance = 1.0); // 0 = closed form only
+    void outlierRejection(float thresholdCm, int maxRejects = 1);    // Leave out NLOS anchors (0 = off)
+    uint8_t getRejectedAnchors();                // Anchors left out of the latest fix
+    uint32_t getAnchorRejections(int anchorID);  // Fixes that left this anchor out
+    bool getPredictedPosition(int tagID, float& x, float& y);
+    bool getPredictedPosition(int tagID, unsigned long atTime, float& x, float& y);
+    unsigned long getTagTimestamp(int tagID);
+    
+    // Range prefilter between the parser and the solver, per anchor (see UWBRangeFilter.h)
+    void rangeFilter(RangeFilterType type, int window = 5); // RANGE_FILTER_MEDIAN or _HAMPEL (window 3-7)
+    void rangeGate(float maxSpeed);              // Drop ranges changing faster than this (cm/s), 0 = off
+    void rangeSmoothing(float alpha);            // Exponential smoothing of filtered ranges, 0 = off
+    
+    // Trajectory history (own tag and other tags, off by default, see UWBTrajectory.h)
+    void trajectoryHistory(int fixesPerTag);     // 4 bytes per fix per tag, 0 = off
+    bool getTagVelocity(int tagID, float& vx, float& vy); // cm/s
+    float getTagSpeed(int tagID);                // cm/s, 0 if unknown
+    float getTagHeading(int tagID);              // Degrees from +X toward +Y, -1 if not moving
+    bool getTagPositionAt(int tagID, unsigned long atTime, float& x, float& y);
+    int copyTrajectory(int tagID, UWBTrajectoryPoint* out, int maxCount); // Newest first
+    
+    // Distributed solving: send own fixes to the Position Server, which
+    // then stores them instead of solving this tag again
+    void uploadFixes(unsigned long intervalMs);  // At most one FIX per interval (0 = off, default)
+    
+    // Clock sync with the Position Server (see UWBClockSync.h). Requests
+    // ride on FIX uploads or small SYNC frames and are answered in ALLPOS;
+    // other tags' fix times then follow the shared timebase.
+    void clockSync(unsigned long intervalMs);    // One request per interval (0 = off, default)
+    bool isClockSynced();
+    double getClockOffset();                     // ms, server clock minus ours
+    float getClockDrift();                       // ppm, positive if the server's clock runs faster
+    unsigned long getClockDelay();               // ms, round trip of the estimate in use
+    unsigned long serverTime();                  // Server's millis() now
+    unsigned long serverTime(unsigned long localTime);
+    unsigned long localTime(unsigned long serverTime);
+    
+    // Link quality of this tag's own range reports
+    const UWBLinkStats& getLinkStats();
+    float getLinkQuality();                      // Received / expected reports
+    void printLinkStats(Print& out = Serial);    // One LINK line
+    
+    // update() scheduling (see UWBScheduler.h)
+    void taskPeriod(UWBTask task, unsigned long ms);
+    void taskBudget(UWBTask task, unsigned long ms);
+    void enableTask(UWBTask task, bool enabled);  // e.g. TASK_TELEMETRY
+    uint32_t getTaskOverruns(UWBTask task);
+    void printTaskStats(Print& out = Serial);     // One TASK line per task
+    
+    // Memory telemetry (see UWBMemory.h)
+    void memoryTelemetry(unsigned long periodMs); // Sample heap and stack every periodMs (0 = off, default)
+    bool getMemoryStats(UWBMemorySample& out);    // Latest sample, false before the first
+    void getAllocations(int bucket, UWBAllocCount& out); // UWBTask value or UWB_ALLOC_OTHER
+    void printMemoryStats(Print& out = Serial);   // MEM line, one ALLOC line per subsystem
+    
+    // Public variables for accessing data
+    float positionX;
+    float positionY;
+    unsigned long positionTime; // millis() when positionX/Y were measured
+    float a0Distance;
+    float a1Distance;
+    float a2Distance;
+    float a3Distance;
+    
+private:
+    // Hardware configuration (hardcoded for ESP32S3)
+    static const int RESET_PIN = 16;
+    static const int IO_RXD2 = 18;
+    static const int IO_TXD2 = 17;
+    static const int I2C_SDA = 39;
+    static const int I2C_SCL = 38;
+    
+    // Configuration variables
+    int _tagNumber;
+    unsigned long _refreshRate;
+    int _totalTags;
+    float _anchorPositions[4][2]; // [anchor][x,y]
+    UWBSolver _solver;            // Same anchors (or the active zone's), used for the position solve
+    UWBSite _site;                // Anchor zones for large sites
+    float _ranges[UWBSolver::MAX_ANCHORS]; // Latest report, all anchor IDs
+    uint8_t _rangeMask;
+    uint8_t _rejectedAnchors;     // Outliers left out of the latest fix
+    uint32_t _anchorRejections[UWBSolver::MAX_ANCHORS];
+    uint32_t _rangeReportSeq;     // Module sequence number of the latest report
+    
+    // Fix upload (distributed solving)
+    bool _uploadPending;          // New fix since the last FIX frame
+    uint32_t _fixSeq;             // Report the fix was solved from
+    float _fixResidual;
+    
+    // Clock sync with the Position Server
+    UWBClockSync _clockSync;
+    bool _syncPending;            // Next FIX frame carries a sync request
+    int _syncShard;               // Shard of the server that answered
+    
+    // Last raw (unfiltered) fix, warm start for iterative refinement
+    float _rawFixX;
+    float _rawFixY;
+    unsigned long _rawFixTime;
+    bool _rawFixValid;
+    
+#if UWB_ENABLE_DISPLAY
+    // Display
+    Adafruit_SSD1306* _display;
+    bool _displayInitialized;
+#endif
+    
+    // Position filtering (configurable, defaults to raw fixes)
+    static const int MAX_POSITION_HISTORY = 8;
+    float _positionXHistory[MAX_POSITION_HISTORY];
+    float _positionYHistory[MAX_POSITION_HISTORY];
+    int _positionHistoryLength;
+    int _positionHistoryIndex;
+    bool _positionHistoryFilled;
+    PositionFilter _filterType;
+    float _filterAlpha;
+    float _filterBeta;
+    
+    // Motion prediction
+    static const float PREDICTOR_BETA;  // Velocity gain for pass-through tracks
+    UWBMotionFilter _selfMotion;
+    unsigned long _predictionHorizon;
+    
+    // Trajectory history (allocated by trajectoryHistory()); track n is
+    // _otherTags[n], the last track is our own tag
+    UWBTrajectoryStore* _trajectories;
+    int trajectoryTrack(int tagID);
+    
+    // Range prefilter (allocated by rangeFilter/rangeGate/rangeSmoothing)
+    UWBRangeFilter* _rangeFilter;
+    UWBRangeFilter& rangeFilterState();
+    
+#if UWB_ENABLE_MULTITAG
+    // Multi-tag tracking
+    static const int MAX_OTHER_TAGS = UWB_MAX_OTHER_TAGS;
+    OtherTag _otherTags[MAX_OTHER_TAGS];
+    int _activeOtherTagCount;
+    static const unsigned long SAME_FIX_WINDOW = 20; // ms; a repeated position this close to the stored fix time is that fix
+#endif
+    
+    // Zones; slot n is _otherTags[n], the last slot is our own tag
+    UWBZoneEngine _zones;
+    
+    // Event callbacks
+    RangeCallback _onRange;
+    PositionCallback _onPosition;
+    TagEventCallback _onTagSeen;
+    TagEventCallback _onTagLost;
+    uint32_t _rangeSeq;
+    uint32_t _positionSeq;
+    
+    // Link telemetry
+    UWBLinkStats _linkStats;
+    
+    // Guards positionX/Y/Time and the other tags' positions for snapshots
+    UWBSeqLock _tagLock;
+    
+    // Scheduling
+    UWBScheduler _scheduler;
+    bool _solvePending;
+    static void taskIngest(void* self);
+    static void taskSolve(void* self);
+    static void taskRanging(void* self);
+    static void taskTelemetry(void* self);
+    static void taskUpload(void* self);
+    static void taskMemory(void* self);
+    static void taskSync(void* self);
+    
+    // Memory telemetry
+    UWBMemorySample _memorySample;
+    bool _memorySampled;
+    
+    // Communication
+    static const int RESPONSE_RESERVE = 256;   // Module line buffer; longer lines grow it once
+    String _response;
+    
+    // Private methods
+    void initializeHardware();
+    void configureUWBModule();
+    void parseRangeData(const String& data);
+    void parseAnchorData(const String& data);
+    void calculatePosition();
+    void readUWBData();
+    void uploadFix();
+    void requestClockSync();
+    void parseClockSync(const String& data);
+#if UWB_ENABLE_DISPLAY
+    static void taskDisplay(void* self);
+    void updateDisplay();
+#endif
+#if UWB_ENABLE_MULTITAG
+    void parsePositionData(const String& data);
+    OtherTag* getOtherTag(int tagID);
+    void updateOtherTag(int tagID, float x, float y, int shard, unsigned long fixTime);
+#endif
+    String sendCommand(String command, int timeout = 500, bool debug = false);
+    void sendCommandAsync(const char* command);   // Replies are consumed by readUWBData()
+    void sendDataAsync(const char* payload, int length); // AT+DATA without building a String
+};
+
+class UWBAnchor {
+public:
+    // Constructor (POSITION_SERVER only tracks link stats with
+    // UWB_ENABLE_POSITION_SERVER 0)
+    UWBAnchor(AnchorType type);
+    
+    // Destructor
+    ~UWBAnchor();
+    
+    // Configuration methods
+    void setAnchorNumber(int anchorNum);
+    void setAnchorPosition(float x, float y);
+    void refreshRate(unsigned long rate);
+    void totalTags(int count);
+    
+    // Anchor network configuration (for Position Server)
+    void setOtherAnchor(int anchorID, float x, float y);
+    
+    // Sharding: several Position Servers each own part of the tag IDs
+    void setShard(int shardIndex, int shardCount);     // Owns tagID % shardCount == shardIndex
+    void setShardRange(int firstTagID, int lastTagID);  // Owns firstTagID..lastTagID (shard index 0)
+    void setShardRange(int shardIndex, int firstTagID, int lastTagID);
+    bool ownsTag(int tagID);
+    
+    // Main update method
+    void update();
+    
+    // Data access methods (for Position Server type)
+    int getTrackedTagCount();
+    float getTagX(int tagID);
+    float getTagY(int tagID);
+    bool isTagActive(int tagID);
+    unsigned long getTagLastSeen(int tagID);
+    int copyTags(UWBTagPosition* out, int maxCount);      // All active tags in one pass; returns count
+    bool getTagPosition(int tagID, UWBTagPosition& out);  // Torn-free, safe from another task or core
+    uint32_t getTagSeq(int tagID);                 // Module sequence number of the latest report
+    float getTagRssi(int tagID, int anchorID);     // dBm, 0 if unknown
+    
+    // Range prefilter between the parser and the solver, per tag and anchor
+    // (Position Server, off by default, see UWBRangeFilter.h)
+    void rangeFilter(RangeFilterType type, int window = 5); // RANGE_FILTER_MEDIAN or _HAMPEL (window 3-7)
+    void rangeGate(float maxSpeed);              // Drop ranges changing faster than this (cm/s), 0 = off
+    void rangeSmoothing(float alpha);            // Exponential smoothing of filtered ranges, 0 = off
+    
+    // Trajectory history of tracked tags (Position Server, off by default)
+    void trajectoryHistory(int fixesPerTag);     // 4 bytes per fix per tag, 0 = off
+    bool getTagVelocity(int tagID, float& vx, float& vy); // cm/s
+    float getTagSpeed(int tagID);                // cm/s, 0 if unknown
+    float getTagHeading(int tagID);              // Degrees from +X toward +Y, -1 if not moving
+    bool getTagPositionAt(int tagID, unsigned long atTime, float& x, float& y);
+    int copyTrajectory(int tagID, UWBTrajectoryPoint* out, int maxCount); // Newest first
+    
+    // Zone methods (Position Server evaluates every tracked tag)
+    int addCircleZone(float x, float y, float radius);
+    int addRectZone(float x1, float y1, float x2, float y2);
+    int addPolygonZone(const float* xs, const float* ys, int count);
+    bool removeZone(int zoneID);
+    void zoneHysteresis(float cm);
+    void onZoneEnter(ZoneCallback callback);
+    void onZoneExit(ZoneCallback callback);
+    bool isTagInZone(int tagID, int zoneID);
+    
+    // Event callbacks (called from update() as soon as data is parsed)
+    void onRange(RangeCallback callback);        // Every AT+RANGE report
+    void onPosition(PositionCallback callback);  // Position Server fixes
+    void onTagSeen(TagEventCallback callback);   // New tag starts reporting
+    void onTagLost(TagEventCallback callback);   // Tag silent for 5 seconds
+    
+    // Position solve (Position Server)
+    void solverIterations(int maxIterations, float tolerance = 1.0); // 0 = closed form only
+    void solveInterval(unsigned long ms);        // Solve each tag at most this often (0 = every update)
+    void outlierRejection(float thresholdCm, int maxRejects = 1);    // Leave out NLOS anchors (0 = off)
+    uint32_t getAnchorRejections(int anchorID);  // Fixes that left this anchor out
+    
+    // Anchor self-survey (see UWBSurvey.h); tags must be off meanwhile.
+    // Every anchor takes one turn, one anchor at a time:
+    void surveyTurn(unsigned long delayMs, unsigned long durationMs); // Range to the others as tag <anchor number>
+    bool isSurveyTurn();                         // Turn pending or running
+    // The collecting anchor (usually the Position Server):
+    void startSurvey();                          // Collect the turns' anchor-to-anchor ranges
+    bool finishSurvey();                         // Solve, apply and broadcast ANCHORS to tags
+    bool getSurveyAnchor(int anchorID, float& x, float& y);
+    float getSurveyResidual();                   // RMS range error (cm), -1 before a solve
+    void printSurvey(Print& out = Serial);       // One SURVEY line per anchor pair and solved anchor
+    
+    // Data Logger output
+    void loggerFormat(LoggerFormat format);
+    uint32_t getLoggerDrops();                   // Binary frames dropped (logger or position stream)
+    
+    // Position stream (Position Server): every fix as a FRAME_POSITION on
+    // Serial as soon as it is solved or uploaded (see UWBStream.h)
+    void streamPositions(bool enabled);
+    
+    // Link quality per tag (every anchor type)
+    bool getLinkStats(int tagID, UWBLinkStats& stats);
+    float getLinkQuality(int tagID);             // Received / expected, 0 if unknown tag
+    void printLinkStats(Print& out = Serial);    // One LINK line per active tag
+    
+    // update() scheduling (see UWBScheduler.h)
+    void taskPeriod(UWBTask task, unsigned long ms);
+    void taskBudget(UWBTask task, unsigned long ms);
+    void enableTask(UWBTask task, bool enabled);  // e.g. TASK_TELEMETRY
+    uint32_t getTaskOverruns(UWBTask task);
+    void printTaskStats(Print& out = Serial);     // One TASK line per task
+    
+    // Memory telemetry (see UWBMemory.h)
+    void memoryTelemetry(unsigned long periodMs); // Sample heap and stack every periodMs (0 = off, default)
+    bool getMemoryStats(UWBMemorySample& out);    // Latest sample, false before the first
+    void getAllocations(int bucket, UWBAllocCount& out); // UWBTask value or UWB_ALLOC_OTHER
+    void printMemoryStats(Print& out = Serial);   // MEM line, one ALLOC line per subsystem
+    
+    // Public variables
+    AnchorType anchorType;
+    int trackedTagCount;
+    
+private:
+    // Hardware configuration (hardcoded for ESP32S3)
+    static const int RESET_PIN = 16;
+    static const int IO_RXD2 = 18;
+    static const int IO_TXD2 = 17;
+    static const int I2C_SDA = 39;
+    static const int I2C_SCL = 38;
+    
+    // Configuration variables
+    int _anchorNumber;
+    float _anchorPosition[2]; // [x,y]
+    unsigned long _refreshRate;
+    int _totalTags;
+    
+    // Other anchor positions (for Position Server)
+    static const int MAX_ANCHORS = UWBSolver::MAX_ANCHORS;
+#if UWB_ENABLE_POSITION_SERVER
+    UWBSolver _solver;
+    uint32_t _anchorRejections[MAX_ANCHORS];
+#endif
+    
+#if UWB_ENABLE_DISPLAY
+    // Display
+    Adafruit_SSD1306* _display;
+    bool _displayInitialized;
+#endif
+    
+    // Tag tracking (for Position Server)
+    static const int MAX_TRACKED_TAGS = UWB_MAX_TRACKED_TAGS;
+    TrackedTag _trackedTags[MAX_TRACKED_TAGS];
+    UWBLinkStats _linkStats[MAX_TRACKED_TAGS];  // Parallel to _trackedTags
+    UWBSeqLock _tagLock;                        // Guards tag IDs, flags and fixes for snapshots
+    UWBTrajectoryStore* _trajectories;          // Parallel to _trackedTags (trajectoryHistory())
+    int trajectoryTrack(int tagID);
+    UWBRangeFilter* _rangeFilter;               // Parallel to _trackedTags (rangeFilter())
+    UWBRangeFilter& rangeFilterState();
+    
+    // Zones
+    UWBZoneEngine _zones;                       // Parallel to _trackedTags
+    
+    // Sharding (for Position Server)
+    int _shardIndex;
+    int _shardCount;      // 1 = unsharded, owns every tag
+    int _shardFirstTag;   // Range mode when _shardFirstTag >= 0
+    int _shardLastTag;
+#if UWB_ENABLE_POSITION_SERVER
+    int _lastBroadcastCount;
+    int _dirtyCount;                  // Tags with ranges waiting for a solve
+    unsigned long _solveInterval;
+    unsigned long _solveDue;          // No waiting tag is due before this
+    
+    // Clock sync requests, answered in the next ALLPOS frame
+    static const int MAX_SYNC_ECHOES = 4;
+    UWBSyncEcho _syncEchoes[MAX_SYNC_ECHOES];
+    int _syncEchoCount;
+    
+    // ALLPOS frame, built in place so a broadcast needs no heap
+    static const int ALLPOS_ENTRY_SIZE = 48;   // ":<tid>:<x>:<y>:<age>"
+    char _broadcastFrame[64 + MAX_SYNC_ECHOES * 40 + MAX_TRACKED_TAGS * ALLPOS_ENTRY_SIZE];
+#endif
+    
+    // Event callbacks
+    RangeCallback _onRange;
+    PositionCallback _onPosition;
+    TagEventCallback _onTagSeen;
+    TagEventCallback _onTagLost;
+    uint32_t _rangeSeq;
+    uint32_t _positionSeq;
+    
+    // Binary logger output (allocated when LOG_BINARY is selected)
+    static const int LOG_BATCH_BYTES = 256;          // Write once this much is queued
+    static const unsigned long LOG_FLUSH_INTERVAL = 20; // ...or this often (ms)
+    LoggerFormat _loggerFormat;
+    UWBFrameQueue* _logQueue;
+    uint32_t _reportedLogDrops;
+    unsigned long _lastLogFlush;
+    bool _streamPositions;              // Position Server fixes go to _logQueue too
+    
+    // Anchor survey
+    enum SurveyTurn { SURVEY_IDLE, SURVEY_WAITING, SURVEY_TO_TAG, SURVEY_RANGING, SURVEY_TO_ANCHOR };
+    UWBSurvey* _survey;                 // Allocated by startSurvey()
+    bool _surveyCollecting;
+    SurveyTurn _surveyTurn;
+    int _surveyStep;                    // Next module configuration step while switching
+    unsigned long _surveyNext;          // Start of the turn, then of the next step
+    unsigned long _surveyDuration;      // Ranging time as a tag
+    unsigned long _surveyEnd;
+    static void taskSurvey(void* self);
+    
+    // Scheduling
+    UWBScheduler _scheduler;
+    static void taskIngest(void* self);
+    static void taskExpiry(void* self);
+    static void taskTelemetry(void* self);
+    static void taskLogger(void* self);
+    static void taskMemory(void* self);
+    
+    // Memory telemetry
+    UWBMemorySample _memorySample;
+    bool _memorySampled;
+    
+    // Communication
+    static const int RESPONSE_RESERVE = 256;   // Module line buffer; longer lines grow it once
+    String _response;
+    
+    // Private methods
+    void initializeHardware();
+    void configureUWBModule();
+    void parseRangeData(const String& data);
+    void readUWBData();
+#if UWB_ENABLE_DISPLAY
+    bool _newData;
+    static void taskDisplay(void* self);
+    void updateDisplay();
+#endif
+    
+    // Type-specific methods
+    void processDataLogger();
+    void expireTags();
+    void logRangeRecord(int tagID, const float* distances, uint32_t seq, unsigned long timestamp);
+    void streamPosition(int tagID, float x, float y, uint32_t seq, float residual,
+                        uint8_t mask, uint8_t flags, unsigned long timestamp);
+    void flushLogQueue();
+    bool binaryOutput();                // USB carries binary frames, not text
+    TrackedTag* getTrackedTag(int tagID);
+    static const unsigned long MAX_FIX_AGE = 60000; // ms; an active tag's older fix is dropped
+    
+#if UWB_ENABLE_POSITION_SERVER
+    // Position calculation (for Position Server)
+    static const unsigned long FIX_UPLOAD_TIMEOUT = 2000; // ms; solve the tag again after this
+    static void taskSolve(void* self);
+    static void taskBroadcast(void* self);
+    void solveDirtyTags(bool all);
+    void processPositionServer();
+    void parseFixData(const String& data);
+    void parseSyncData(const String& data);
+    void queueSyncEcho(int tagID, uint32_t sent, unsigned long received);
+    void calculateTagPosition(int tagIndex);
+    void broadcastAllPositions();
+#endif
+    
+    String sendCommand(String command, int timeout = 500, bool debug = false);
+    void sendCommandAsync(const char* command);   // Replies are consumed by readUWBData()
+    void sendDataAsync(const char* payload, int length); // AT+DATA without building a String
+};
+
+#endif
\ No newline at end of file
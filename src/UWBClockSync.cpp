@@ -0,0 +1,157 @@
+#include "UWBClockSync.h"
+#include <math.h>
+
+const float UWBClockSync::MAX_DRIFT = 500.0;
+
+// Rounds a millisecond offset to the nearest whole millisecond
+static int32_t roundMs(float ms) {
+    return (int32_t)(ms >= 0 ? ms + 0.5f : ms - 0.5f);
+}
+
+UWBClockSync::UWBClockSync() {
+    reset();
+}
+
+void UWBClockSync::reset() {
+    _head = 0;
+    _count = 0;
+    _samples = 0;
+    _spanStart = 0;
+    _spanValid = false;
+    _pointHead = 0;
+    _pointCount = 0;
+    _drift = 0.0;
+}
+
+bool UWBClockSync::addSample(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4) {
+    // Differences of wrapping stamps; each clock is only compared with itself
+    // for the delay, and across clocks for the offset
+    int32_t elapsed = (int32_t)(t4 - t1);
+    int32_t hold = (int32_t)(t3 - t2);
+    if (elapsed < 0 || hold < 0) {
+        return false;
+    }
+    int32_t delay = elapsed - hold;
+    if (delay < 0) delay = 0;  // Both clocks tick in whole ms
+    if ((uint32_t)delay > MAX_DELAY) {
+        return false;
+    }
+
+    Sample& sample = _ring[_head];
+    sample.time = t4;
+    int64_t twice = (int64_t)(int32_t)(t2 - t1) + (int32_t)(t3 - t4);
+    sample.offset = (int32_t)(twice >> 1);   // Rounds down, odd sums leave half a ms
+    sample.fraction = (twice & 1) ? 0.5f : 0.0f;
+    sample.delay = (uint32_t)delay;
+    _head = (_head + 1) % SAMPLES;
+    if (_count < SAMPLES) _count++;
+    _samples++;
+
+    updateDrift(sample);
+    return true;
+}
+
+int UWBClockSync::best() const {
+    // Shortest round trip; the newest wins a tie
+    int index = -1;
+    for (int i = 0; i < _count; i++) {
+        int slot = (_head - 1 - i + SAMPLES) % SAMPLES;
+        if (index < 0 || _ring[slot].delay < _ring[index].delay) {
+            index = slot;
+        }
+    }
+    return index;
+}
+
+void UWBClockSync::updateDrift(const Sample& sample) {
+    if (_spanValid && (int32_t)(sample.time - _spanStart) >= (int32_t)DRIFT_SPAN) {
+        _points[_pointHead] = _spanBest;
+        _pointHead = (_pointHead + 1) % DRIFT_POINTS;
+        if (_pointCount < DRIFT_POINTS) _pointCount++;
+        _spanValid = false;
+        fitDrift();
+    }
+    if (!_spanValid) {
+        _spanBest = sample;
+        _spanStart = sample.time;
+        _spanValid = true;
+    } else if (sample.delay <= _spanBest.delay) {
+        _spanBest = sample;
+    }
+}
+
+void UWBClockSync::fitDrift() {
+    if (_pointCount < 2) return;
+
+    // Least squares over the points, times and offsets relative to the
+    // newest one so the sums stay small
+    const Sample& newest = _points[(_pointHead - 1 + DRIFT_POINTS) % DRIFT_POINTS];
+    float t[DRIFT_POINTS], o[DRIFT_POINTS];
+    float meanT = 0, meanO = 0;
+    for (int i = 0; i < _pointCount; i++) {
+        t[i] = (float)(int32_t)(_points[i].time - newest.time);
+        o[i] = (float)(_points[i].offset - newest.offset) + (_points[i].fraction - newest.fraction);
+        meanT += t[i];
+        meanO += o[i];
+    }
+    meanT /= _pointCount;
+    meanO /= _pointCount;
+    float stt = 0, sto = 0;
+    for (int i = 0; i < _pointCount; i++) {
+        float dt = t[i] - meanT;
+        stt += dt * dt;
+        sto += dt * (o[i] - meanO);
+    }
+    if (stt <= 0) return;
+
+    float slope = sto / stt * 1e6f;
+    if (slope <= MAX_DRIFT && slope >= -MAX_DRIFT) {
+        _drift = slope;
+    }
+}
+
+void UWBClockSync::offsetAt(uint32_t localTime, int32_t& whole, float& fraction) const {
+    if (_count == 0) {
+        whole = 0;
+        fraction = 0.0;
+        return;
+    }
+    const Sample& sample = _ring[best()];
+    fraction = sample.fraction + _drift * 1e-6f * (int32_t)(localTime - sample.time);
+    float carry = floorf(fraction);
+    whole = sample.offset + (int32_t)carry;
+    fraction -= carry;
+}
+
+double UWBClockSync::getOffset(uint32_t localTime) const {
+    int32_t whole;
+    float fraction;
+    offsetAt(localTime, whole, fraction);
+    return whole + (double)fraction;
+}
+
+uint32_t UWBClockSync::getDelay() const {
+    return (_count > 0) ? _ring[best()].delay : 0;
+}
+
+uint32_t UWBClockSync::toServer(uint32_t localTime) const {
+    int32_t whole;
+    float fraction;
+    offsetAt(localTime, whole, fraction);
+    return localTime + whole + roundMs(fraction);
+}
+
+uint32_t UWBClockSync::toLocal(uint32_t serverTime) const {
+    // The offset is a function of local time, and serverTime is off from
+    // local time by the offset itself - days against a long-running server,
+    // which the drift term would turn into seconds. The first pass finds
+    // the local time to within the offset's change, the second evaluates
+    // the offset there; what is left is drift times that change, far
+    // below a ms.
+    int32_t whole;
+    float fraction;
+    offsetAt(serverTime, whole, fraction);
+    uint32_t approx = serverTime - whole - roundMs(fraction);
+    offsetAt(approx, whole, fraction);
+    return serverTime - whole - roundMs(fraction);
+}
@@ -0,0 +1,81 @@
+#ifndef UWB_CLOCK_SYNC_H
+#define UWB_CLOCK_SYNC_H
+
+#include <stdint.h>
+
+// Estimates a tag's clock offset and drift against the Position Server
+// from round trips carried by the existing AT+DATA / AT+RDATA exchange
+// (NTP style). Each round trip gives four millis() stamps:
+//
+//   t1  tag sends the request (SYNC frame or an uploaded FIX)   tag clock
+//   t2  server receives it                                      server clock
+//   t3  server sends the ALLPOS frame that echoes t1 and t2     server clock
+//   t4  tag receives that frame                                 tag clock
+//
+//   offset = ((t2 - t1) + (t3 - t4)) / 2     (server minus tag)
+//   delay  = (t4 - t1) - (t3 - t2)           (time on the air and in queues)
+//
+// The offset is exact when both directions take equally long; the error
+// is half the difference. The longer a round trip, the more room for such
+// asymmetry, so of the last SAMPLES round trips the one with the shortest
+// delay is used. For drift, the shortest round trip of every DRIFT_SPAN
+// is kept; the least-squares slope over the last DRIFT_POINTS of them
+// carries the offset forward between round trips and through gaps.
+// Offsets are kept as whole ms plus a fraction: a server that has been up
+// for days is far ahead of a tag that booted later, and a float alone
+// holds whole ms only up to ~4.7 h. Fixed size, no allocation.
+
+class UWBClockSync {
+public:
+    static const int SAMPLES = 8;
+    static const unsigned long MAX_DELAY = 1000;      // ms, longer round trips are discarded
+    static const int DRIFT_POINTS = 8;
+    static const unsigned long DRIFT_SPAN = 30000;    // ms per drift point
+    static const float MAX_DRIFT;                     // ppm, larger slopes are discarded
+
+    UWBClockSync();
+
+    void reset();
+
+    // Fold in one round trip; false if it was discarded
+    bool addSample(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4);
+
+    bool isSynced() const { return _count > 0; }
+    double getOffset(uint32_t localTime) const;   // ms, server minus local at that time
+    float getDrift() const { return _drift; }      // ppm, server clock runs faster if positive
+    uint32_t getDelay() const;                     // ms, round trip of the sample in use
+    uint32_t getSamples() const { return _samples; }
+
+    // Conversions; unchanged while not synced
+    uint32_t toServer(uint32_t localTime) const;
+    uint32_t toLocal(uint32_t serverTime) const;
+
+private:
+    struct Sample {
+        uint32_t time;      // t4, tag clock
+        int32_t offset;     // ms, whole part
+        float fraction;     // ms, 0 or 0.5
+        uint32_t delay;     // ms
+    };
+
+    int best() const;
+    void offsetAt(uint32_t localTime, int32_t& whole, float& fraction) const;
+    void updateDrift(const Sample& sample);
+    void fitDrift();
+
+    Sample _ring[SAMPLES];
+    int _head;
+    int _count;
+    uint32_t _samples;      // Round trips accepted
+
+    // Drift: shortest round trip per span, and the last spans' ones
+    Sample _spanBest;
+    uint32_t _spanStart;
+    bool _spanValid;
+    Sample _points[DRIFT_POINTS];
+    int _pointHead;
+    int _pointCount;
+    float _drift;
+};
+
+#endif
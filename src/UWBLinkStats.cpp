@@ -0,0 +1,63 @@
+#include "UWBLinkStats.h"
+
+static const uint32_t SEQ_MASK = (1UL << UWB_SEQ_BITS) - 1;
+
+UWBLinkStats::UWBLinkStats() {
+    reset();
+}
+
+void UWBLinkStats::reset() {
+    _received = 0;
+    _expected = 0;
+    _lost = 0;
+    _duplicates = 0;
+    _reorders = 0;
+    _lastSeq = 0;
+    _started = false;
+    _sequenced = false;
+    _lastReport = 0;
+}
+
+void UWBLinkStats::update(bool hasSeq, uint32_t seq, unsigned long now) {
+    bool stale = _started && (now - _lastReport > RESYNC_GAP);
+    _started = true;
+    _lastReport = now;
+
+    if (!hasSeq) {
+        _received++;
+        _expected++;
+        return;
+    }
+
+    seq &= SEQ_MASK;
+    if (!_sequenced || stale) {
+        // First report, or too long a silence to tell how many wrapped past
+        _sequenced = true;
+        _lastSeq = seq;
+        _received++;
+        _expected++;
+        return;
+    }
+
+    uint32_t delta = (seq - _lastSeq) & SEQ_MASK;
+    if (delta == 0) {
+        if (_duplicates < 0xFFFF) _duplicates++;
+    } else if (delta <= (SEQ_MASK >> 1)) {
+        // In order, possibly after a gap
+        _expected += delta;
+        _lost += delta - 1;
+        _received++;
+        _lastSeq = seq;
+    } else {
+        // Older than the newest report: it arrived late, not lost
+        if (_reorders < 0xFFFF) _reorders++;
+        if (_lost > 0) _lost--;
+        _received++;
+    }
+}
+
+float UWBLinkStats::getQuality() const {
+    if (_expected == 0) return 1.0;
+    float quality = (float)_received / _expected;
+    return quality > 1.0 ? 1.0 : quality;
+}
@@ -0,0 +1,53 @@
+#ifndef UWB_LINK_STATS_H
+#define UWB_LINK_STATS_H
+
+#include <stdint.h>
+
+// Sequence number width of the module's AT+RANGE seq: field
+#ifndef UWB_SEQ_BITS
+#define UWB_SEQ_BITS 8
+#endif
+
+// Link-quality counters for one tag, built from the module sequence
+// numbers in its range reports. Fixed size, no allocation.
+//
+// A forward jump of n counts n-1 reports as lost; a report that arrives
+// after a later one is a reorder and takes its loss back; a repeated
+// sequence number is a duplicate and is not counted as received.
+class UWBLinkStats {
+public:
+    UWBLinkStats();
+
+    void reset();
+
+    // Account for one report (hasSeq false: only received and age are updated)
+    void update(bool hasSeq, uint32_t seq, unsigned long now);
+
+    uint32_t getReceived() const { return _received; }
+    uint32_t getExpected() const { return _expected; }
+    uint32_t getLost() const { return _lost; }
+    uint16_t getDuplicates() const { return _duplicates; }
+    uint16_t getReorders() const { return _reorders; }
+    unsigned long getLastReport() const { return _lastReport; }
+    unsigned long getAge(unsigned long now) const { return _started ? now - _lastReport : 0; }
+
+    // Received / expected (1.0 until sequence numbers have been seen)
+    float getQuality() const;
+
+    // Gaps longer than this restart the sequence instead of counting
+    // a whole wrap of reports as lost
+    static const unsigned long RESYNC_GAP = 5000;
+
+private:
+    uint32_t _received;
+    uint32_t _expected;
+    uint32_t _lost;
+    uint16_t _duplicates;
+    uint16_t _reorders;
+    uint16_t _lastSeq;
+    bool _started;
+    bool _sequenced;
+    unsigned long _lastReport;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "UWBMemory.h"
+#include <stdlib.h>
+#include <new>
+
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// Plain counters: allocations from other FreeRTOS tasks (WiFi, BLE) land
+// in whatever bucket is current and may race, which only blurs the counts
+static UWBAllocCount g_alloc[UWB_ALLOC_BUCKETS];
+static volatile int g_bucket = UWB_ALLOC_OTHER;
+
+bool uwbAllocCounting() {
+    return UWB_COUNT_ALLOCATIONS != 0;
+}
+
+int uwbAllocSetBucket(int bucket) {
+    int previous = g_bucket;
+    g_bucket = (bucket >= 0 && bucket < UWB_ALLOC_BUCKETS) ? bucket : UWB_ALLOC_OTHER;
+    return previous;
+}
+
+void uwbAllocGet(int bucket, UWBAllocCount& out) {
+    if (bucket < 0 || bucket >= UWB_ALLOC_BUCKETS) {
+        out.allocations = out.frees = out.bytes = 0;
+        return;
+    }
+    out = g_alloc[bucket];
+}
+
+uint32_t uwbAllocTotal() {
+    uint32_t total = 0;
+    for (int i = 0; i < UWB_ALLOC_BUCKETS; i++) {
+        total += g_alloc[i].allocations;
+    }
+    return total;
+}
+
+void uwbAllocReset() {
+    for (int i = 0; i < UWB_ALLOC_BUCKETS; i++) {
+        g_alloc[i].allocations = 0;
+        g_alloc[i].frees = 0;
+        g_alloc[i].bytes = 0;
+    }
+}
+
+void uwbMemorySample(UWBMemorySample& out, unsigned long now) {
+#if defined(ESP32)
+    out.freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    out.minFreeHeap = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    out.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    out.stackHighWater = uxTaskGetStackHighWaterMark(NULL); // Bytes on ESP32
+#else
+    out.freeHeap = 0;
+    out.minFreeHeap = 0;
+    out.largestFreeBlock = 0;
+    out.stackHighWater = 0;
+#endif
+    out.time = now;
+}
+
+#if UWB_COUNT_ALLOCATIONS
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    UWBAllocCount& count = g_alloc[g_bucket];
+    count.allocations++;
+    count.bytes += size;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    UWBAllocCount& count = g_alloc[g_bucket];
+    count.allocations++;
+    count.bytes += n * size;
+    return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    UWBAllocCount& count = g_alloc[g_bucket];
+    if (size > 0) {
+        count.allocations++;
+        count.bytes += size;
+    }
+    if (ptr != nullptr) count.frees++;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    if (ptr != nullptr) g_alloc[g_bucket].frees++;
+    __real_free(ptr);
+}
+}
+
+// The C++ runtime's operator new calls malloc from inside a prebuilt
+// library, where --wrap does not reach; these calls are wrapped
+void* operator new(size_t size) {
+    void* ptr = malloc(size ? size : 1);
+#if __cpp_exceptions
+    if (ptr == nullptr) throw std::bad_alloc();
+#endif
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef UWB_MEMORY_H
+#define UWB_MEMORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "UWBScheduler.h"
+
+// Memory telemetry for long-running nodes: heap, fragmentation and stack
+// samples, and heap allocation counts per update() subsystem.
+//
+// Allocations are counted by wrappers around the C allocator, built only
+// with UWB_COUNT_ALLOCATIONS=1 and linked with
+//
+//   -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+//
+// (PlatformIO build_flags; the host tools set both). Each allocation is
+// charged to the scheduler task running at the time, anything else
+// (setup, sketch code) to UWB_ALLOC_OTHER. Without the flag the counters
+// stay at zero.
+//
+// The flag also makes UWBMemory.cpp replace the global operator new,
+// new[], delete and delete[] for the whole program, sketch and other
+// libraries included, because the runtime's own operator new calls
+// malloc where --wrap does not reach. They keep the standard behaviour
+// (malloc/free underneath, std::bad_alloc when exceptions are on), but a
+// sketch or library that replaces them itself will not link with the
+// flag set. Aligned new is not replaced and goes uncounted.
+#ifndef UWB_COUNT_ALLOCATIONS
+#define UWB_COUNT_ALLOCATIONS 0
+#endif
+
+// Buckets: the UWBTask values, then code outside the scheduled tasks
+static const int UWB_ALLOC_OTHER = TASK_COUNT;
+static const int UWB_ALLOC_BUCKETS = TASK_COUNT + 1;
+
+struct UWBAllocCount {
+    uint32_t allocations;   // malloc, calloc, new; a realloc counts as one allocation and one free
+    uint32_t frees;
+    uint32_t bytes;         // Requested bytes
+};
+
+// One sample of the heap and stack, 0 where the platform cannot tell
+// (host builds)
+struct UWBMemorySample {
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;        // Lowest free heap since boot
+    uint32_t largestFreeBlock;   // Largest allocation that can still succeed
+    uint32_t stackHighWater;     // Stack the calling task has never used (bytes)
+    unsigned long time;          // millis() of the sample
+};
+
+bool uwbAllocCounting();                              // Wrappers built in
+int uwbAllocSetBucket(int bucket);                    // Returns the previous bucket
+void uwbAllocGet(int bucket, UWBAllocCount& out);
+uint32_t uwbAllocTotal();                             // Allocations over every bucket
+void uwbAllocReset();
+
+void uwbMemorySample(UWBMemorySample& out, unsigned long now);
+
+#endif
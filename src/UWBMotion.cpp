@@ -0,0 +1,63 @@
+#include "UWBMotion.h"
+
+UWBMotionFilter::UWBMotionFilter() {
+    reset();
+}
+
+void UWBMotionFilter::reset() {
+    x = 0.0;
+    y = 0.0;
+    vx = 0.0;
+    vy = 0.0;
+    timestamp = 0;
+    valid = false;
+}
+
+void UWBMotionFilter::update(float measX, float measY, unsigned long time, float alpha, float beta) {
+    unsigned long elapsed = time - timestamp;
+
+    // (Re)start the track on the first fix or after a long gap
+    if (!valid || elapsed == 0 || elapsed > RESET_GAP) {
+        if (valid && elapsed == 0) {
+            // Same timestamp: just take the newer measurement
+            x = measX;
+            y = measY;
+            return;
+        }
+        x = measX;
+        y = measY;
+        vx = 0.0;
+        vy = 0.0;
+        timestamp = time;
+        valid = true;
+        return;
+    }
+
+    float dt = elapsed / 1000.0;
+
+    // Predict, then correct with the residual
+    float predX = x + vx * dt;
+    float predY = y + vy * dt;
+    float rx = measX - predX;
+    float ry = measY - predY;
+
+    x = predX + alpha * rx;
+    y = predY + alpha * ry;
+    vx += (beta / dt) * rx;
+    vy += (beta / dt) * ry;
+    timestamp = time;
+}
+
+bool UWBMotionFilter::predict(unsigned long atTime, unsigned long maxHorizon, float& outX, float& outY) const {
+    if (!valid) return false;
+
+    // Wraparound-safe age; a query from before the fix returns the fix itself
+    long age = (long)(atTime - timestamp);
+    if (age < 0) age = 0;
+    if ((unsigned long)age > maxHorizon) age = maxHorizon;
+
+    float dt = age / 1000.0;
+    outX = x + vx * dt;
+    outY = y + vy * dt;
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef UWB_MOTION_H
+#define UWB_MOTION_H
+
+// Position filter types for a tag's own position
+enum PositionFilter {
+    FILTER_NONE,        // Raw fix (default, original behavior)
+    FILTER_AVERAGE,     // Moving average over the last N fixes
+    FILTER_ALPHA_BETA   // Constant-velocity alpha-beta tracker
+};
+
+// Constant-velocity (alpha-beta) tracker for one tag.
+// With alpha = 1 it passes fixes through unchanged and only estimates
+// velocity, which is what extrapolation to "now" needs.
+class UWBMotionFilter {
+public:
+    UWBMotionFilter();
+
+    void reset();
+
+    // Feed a fix measured at timestamp (millis)
+    void update(float measX, float measY, unsigned long timestamp, float alpha, float beta);
+
+    // Extrapolate to atTime, never further than maxHorizon ms past the last fix
+    bool predict(unsigned long atTime, unsigned long maxHorizon, float& outX, float& outY) const;
+
+    float x, y;               // Filtered position (cm)
+    float vx, vy;             // Velocity (cm/s)
+    unsigned long timestamp;  // Time of the last fix (millis)
+    bool valid;
+
+    // Gaps longer than this restart the track instead of inventing velocity
+    static const unsigned long RESET_GAP = 2000;
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "UWBProtocol.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Parse a "(v0,v1,...)" list starting after the "(". Entries whose mask bit
+// is clear are skipped; with useMask false every entry is converted and
+// non-zero values set their bit in *found.
+static void parseList(const char* p, uint8_t mask, bool useMask, float* values, uint8_t* found) {
+    const char* end = strchr(p, ')');
+    if (end == nullptr) {
+        return;
+    }
+
+    for (int i = 0; i < 8 && p < end; i++) {
+        if (!useMask || (mask & (1 << i))) {
+            float value = strtof(p, nullptr);
+            values[i] = value;
+            if (found != nullptr && value > 0) {
+                *found |= (1 << i);
+            }
+        }
+
+        const char* comma = (const char*)memchr(p, ',', end - p);
+        if (comma == nullptr) break;
+        p = comma + 1;
+    }
+}
+
+bool parseRangeReport(const char* line, UWBRangeReport& report) {
+    if (strncmp(line, "AT+RANGE=", 9) != 0) {
+        return false;
+    }
+
+    report.tagID = -1;
+    report.hasRanges = false;
+    report.hasSeq = false;
+    report.hasRssi = false;
+    report.mask = 0;
+    report.seq = 0;
+    for (int i = 0; i < 8; i++) {
+        report.range[i] = 0.0;
+        report.rssi[i] = 0.0;
+    }
+
+    // Extract tag ID (must be followed by a comma)
+    const char* tid = strstr(line, "tid:");
+    if (tid == nullptr || strchr(tid, ',') == nullptr) {
+        return false;
+    }
+    report.tagID = atoi(tid + 4);
+
+    // Anchor mask first, so missing anchors are never converted
+    const char* maskField = strstr(line, "mask:");
+    bool hasMask = (maskField != nullptr);
+    uint8_t mask = hasMask ? (uint8_t)strtoul(maskField + 5, nullptr, 16) : 0;
+
+    const char* seqField = strstr(line, "seq:");
+    if (seqField != nullptr) {
+        report.seq = (uint32_t)strtoul(seqField + 4, nullptr, 10);
+        report.hasSeq = true;
+    }
+
+    const char* rangeStart = strstr(line, "range:(");
+    if (rangeStart == nullptr) {
+        return true;
+    }
+    if (strchr(rangeStart, ')') == nullptr) {
+        return true;
+    }
+    parseList(rangeStart + 7, mask, hasMask, report.range, &report.mask);
+    report.hasRanges = true;
+
+    // A set mask bit with a zero range still counts as missing
+    const char* rssiStart = strstr(line, "rssi:(");
+    if (rssiStart != nullptr) {
+        parseList(rssiStart + 6, report.mask, true, report.rssi, nullptr);
+        report.hasRssi = true;
+    }
+    return true;
+}
+
+int formatFixReport(const UWBFixReport& fix, char* out, int size) {
+    int n = snprintf(out, size, "FIX:%d:%lu:%.1f:%.1f:%.1f:%lu", fix.tagID, (unsigned long)fix.seq,
+                     fix.x, fix.y, fix.residual, (unsigned long)fix.age);
+    if (fix.hasSent && n > 0 && n < size) {
+        n += snprintf(out + n, size - n, ":%lu", (unsigned long)fix.sent);
+    }
+    return (n > 0 && n < size) ? n : 0;
+}
+
+// Move p past the next ':'; false at the end of the payload
+static bool nextField(const char*& p) {
+    const char* colon = strchr(p, ':');
+    if (colon == nullptr) return false;
+    p = colon + 1;
+    return true;
+}
+
+bool parseFixReport(const char* line, UWBFixReport& fix) {
+    const char* p = strstr(line, "FIX:");
+    if (p == nullptr) {
+        return false;
+    }
+    p += 4;
+
+    char* end;
+    fix.tagID = (int)strtol(p, &end, 10);
+    if (end == p) return false;
+    if (!nextField(p)) return false;
+    fix.seq = (uint32_t)strtoul(p, nullptr, 10);
+    if (!nextField(p)) return false;
+    fix.x = strtof(p, nullptr);
+    if (!nextField(p)) return false;
+    fix.y = strtof(p, nullptr);
+    if (!nextField(p)) return false;
+    fix.residual = strtof(p, nullptr);
+    if (!nextField(p)) return false;
+    fix.age = (uint32_t)strtoul(p, &end, 10);
+    if (end == p) return false;
+    p = end;
+    fix.hasSent = nextField(p);
+    if (fix.hasSent) {
+        fix.sent = (uint32_t)strtoul(p, &end, 10);
+        fix.hasSent = (end != p);
+    }
+    return true;
+}
+
+int formatSyncRequest(const UWBSyncRequest& request, char* out, int size) {
+    int n = snprintf(out, size, "SYNC:%d:%lu", request.tagID, (unsigned long)request.sent);
+    return (n > 0 && n < size) ? n : 0;
+}
+
+bool parseSyncRequest(const char* line, UWBSyncRequest& request) {
+    const char* p = strstr(line, "SYNC:");
+    if (p == nullptr) {
+        return false;
+    }
+    p += 5;
+
+    char* end;
+    request.tagID = (int)strtol(p, &end, 10);
+    if (end == p) return false;
+    if (!nextField(p)) return false;
+    request.sent = (uint32_t)strtoul(p, &end, 10);
+    return end != p;
+}
+
+int formatSyncEcho(const UWBSyncEcho& echo, char* out, int size) {
+    int n = snprintf(out, size, "!%d,%lu,%lu", echo.tagID, (unsigned long)echo.sent,
+                     (unsigned long)echo.received);
+    return (n > 0 && n < size) ? n : 0;
+}
+
+bool parseSyncEcho(const char* header, int tagID, UWBSyncEcho& echo) {
+    const char* colon = strchr(header, ':');
+    const char* p = header;
+    while ((p = strchr(p, '!')) != nullptr && (colon == nullptr || p < colon)) {
+        p++;
+        char* end;
+        int id = (int)strtol(p, &end, 10);
+        if (end == p || *end != ',' || id != tagID) continue;
+        p = end + 1;
+        echo.tagID = id;
+        echo.sent = (uint32_t)strtoul(p, &end, 10);
+        if (end == p || *end != ',') return false;
+        p = end + 1;
+        echo.received = (uint32_t)strtoul(p, &end, 10);
+        return end != p;
+    }
+    return false;
+}
+
+int formatAnchorList(const UWBAnchorPosition* anchors, int count, char* out, int size) {
+    int n = snprintf(out, size, "ANCHORS");
+    for (int i = 0; i < count && n > 0 && n < size; i++) {
+        n += snprintf(out + n, size - n, ":%d:%.1f:%.1f", anchors[i].id, anchors[i].x, anchors[i].y);
+    }
+    return (count > 0 && n > 0 && n < size) ? n : 0;
+}
+
+int parseAnchorList(const char* line, UWBAnchorPosition* anchors, int maxCount) {
+    const char* p = strstr(line, "ANCHORS:");
+    if (p == nullptr) {
+        return 0;
+    }
+    p += 8;
+
+    int count = 0;
+    while (count < maxCount) {
+        char* end;
+        int id = (int)strtol(p, &end, 10);
+        if (end == p) break;
+        if (!nextField(p)) break;
+        float x = strtof(p, nullptr);
+        if (!nextField(p)) break;
+        float y = strtof(p, &end);
+        if (end == p) break;
+        anchors[count].id = id;
+        anchors[count].x = x;
+        anchors[count].y = y;
+        count++;
+        if (!nextField(p)) break;
+    }
+    return count;
+}
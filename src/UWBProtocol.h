@@ -0,0 +1,110 @@
+#ifndef UWB_PROTOCOL_H
+#define UWB_PROTOCOL_H
+
+#include <stdint.h>
+
+// Parser for the module's AT+RANGE report lines, shared by the library
+// classes and the host-side tools. Works on plain C strings so it can run
+// on a raw serial buffer without building String copies.
+//
+// Format: AT+RANGE=tid:<id>,mask:<hex>,seq:<n>,range:(<r0>,...,<r7>),rssi:(<s0>,...,<s7>)
+//
+// mask, seq and rssi are optional. When the mask is present it is read
+// first and only the range/RSSI entries of anchors that answered are
+// converted; the others are skipped without parsing.
+
+struct UWBRangeReport {
+    int tagID;
+    bool hasRanges;       // False if the line had no range:(...) list
+    bool hasSeq;          // False if the line had no seq: field
+    bool hasRssi;         // False if the line had no rssi:(...) list
+    uint8_t mask;         // Bit n set = range to anchor n is present
+    uint32_t seq;         // Module sequence number
+    float range[8];       // cm, 0 if missing
+    float rssi[8];        // dBm, 0 if missing
+};
+
+// Returns false if the line is not an AT+RANGE report with a tag ID
+bool parseRangeReport(const char* line, UWBRangeReport& report);
+
+// Fix a tag solved itself and uploads to the Position Server with AT+DATA
+// (the server receives it inside an AT+RDATA line):
+//
+//   FIX:<tid>:<seq>:<x>:<y>:<residual>:<age>[:<sent>]
+//
+// seq is the module sequence number of the range report that was solved,
+// residual the fix's RMS range residual (cm, -1 if unknown) and age the
+// time from the fix to sending it (ms). sent, the tag's millis() when
+// sending, makes the frame a clock sync request as well.
+
+struct UWBFixReport {
+    int tagID;
+    uint32_t seq;
+    float x, y;           // cm
+    float residual;       // cm RMS, -1 if unknown
+    uint32_t age;         // ms
+    bool hasSent;         // Carries a clock sync request
+    uint32_t sent;        // Tag clock
+};
+
+// Writes the FIX payload (without the AT+DATA prefix) and returns its
+// length, or 0 if it does not fit in size bytes
+int formatFixReport(const UWBFixReport& fix, char* out, int size);
+
+// Finds a FIX payload anywhere in the line; false if none or malformed
+bool parseFixReport(const char* line, UWBFixReport& fix);
+
+// Clock sync request from a tag that does not upload fixes (AT+DATA):
+//
+//   SYNC:<tid>:<sent>
+//
+// The Position Server answers in its next ALLPOS frame, whose header
+// carries the server's millis() when sending and one echo per request:
+//
+//   ALLPOS[#<shard>]@<time>[!<tid>,<sent>,<received>...]:<tid>:<x>:<y>:<age>[:...]
+//
+// received is the server's millis() when the request arrived; each
+// position's age is how long before <time> it was measured (ms). Frames
+// without @<time> list <tid>:<x>:<y> only (see UWBClockSync.h).
+
+struct UWBSyncRequest {
+    int tagID;
+    uint32_t sent;        // Tag clock
+};
+
+struct UWBSyncEcho {
+    int tagID;
+    uint32_t sent;        // Tag clock
+    uint32_t received;    // Server clock
+};
+
+// Writes the SYNC payload and returns its length, or 0 if it does not fit
+int formatSyncRequest(const UWBSyncRequest& request, char* out, int size);
+
+// Finds a SYNC payload anywhere in the line; false if none or malformed
+bool parseSyncRequest(const char* line, UWBSyncRequest& request);
+
+// Writes one !<tid>,<sent>,<received> echo and returns its length, or 0
+int formatSyncEcho(const UWBSyncEcho& echo, char* out, int size);
+
+// Finds the echo for tagID in an ALLPOS header (before the first ':')
+bool parseSyncEcho(const char* header, int tagID, UWBSyncEcho& echo);
+
+// Anchor layout broadcast after an anchor survey (AT+DATA from the
+// server, AT+RDATA on tags):
+//
+//   ANCHORS:<id>:<x>:<y>[:<id>:<x>:<y>...]
+
+struct UWBAnchorPosition {
+    int id;
+    float x, y;           // cm
+};
+
+// Writes the ANCHORS payload and returns its length, or 0 if it does not
+// fit in size bytes
+int formatAnchorList(const UWBAnchorPosition* anchors, int count, char* out, int size);
+
+// Finds an ANCHORS payload anywhere in the line; returns the anchors read
+int parseAnchorList(const char* line, UWBAnchorPosition* anchors, int maxCount);
+
+#endif
@@ -0,0 +1,175 @@
+#include "UWBRangeFilter.h"
+#include <math.h>
+
+const float UWBRangeFilter::GATE_MARGIN = 30.0;
+const float UWBRangeFilter::HAMPEL_K = 3.0;
+const float UWBRangeFilter::HAMPEL_MIN = 10.0;
+
+// Scales a median absolute deviation to a standard deviation (normal noise)
+static const float MAD_SCALE = 1.4826;
+
+// Insertion sort: at most MAX_WINDOW values
+static void sortSmall(float* values, int count) {
+    for (int i = 1; i < count; i++) {
+        float value = values[i];
+        int j = i - 1;
+        while (j >= 0 && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+}
+
+static float sortedMedian(const float* sorted, int count) {
+    if (count < 1) return 0.0;
+    return (count & 1) ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5f;
+}
+
+UWBRangeFilter::UWBRangeFilter(int tracks) {
+    if (tracks < 1) tracks = 1;
+    _tracks = tracks;
+    _states = new State[_tracks * ANCHORS];
+    _type = RANGE_FILTER_NONE;
+    _window = 1;
+    _maxSpeed = 0.0;
+    _alpha = 0.0;
+    _gated = 0;
+    for (int i = 0; i < _tracks; i++) {
+        clear(i);
+    }
+}
+
+UWBRangeFilter::~UWBRangeFilter() {
+    delete[] _states;
+}
+
+void UWBRangeFilter::setType(RangeFilterType type, int window) {
+    if (type == RANGE_FILTER_NONE) {
+        window = 1;
+    } else {
+        if (window < 3) window = 3;
+        if (window > MAX_WINDOW) window = MAX_WINDOW;
+        window |= 1; // Odd, so the median is a measured range
+    }
+    if (window != _window) {
+        // Ring positions depend on the size
+        for (int i = 0; i < _tracks; i++) {
+            clear(i);
+        }
+    }
+    _type = type;
+    _window = window;
+}
+
+void UWBRangeFilter::setGate(float maxSpeed) {
+    _maxSpeed = (maxSpeed > 0) ? maxSpeed : 0.0;
+}
+
+void UWBRangeFilter::setSmoothing(float alpha) {
+    if (alpha < 0) alpha = 0;
+    if (alpha > 1) alpha = 1;
+    _alpha = alpha;
+}
+
+void UWBRangeFilter::clear(int track) {
+    if (track < 0 || track >= _tracks) return;
+    for (int a = 0; a < ANCHORS; a++) {
+        State& state = _states[track * ANCHORS + a];
+        state.output = 0.0;
+        state.stamp = 0;
+        state.count = 0;
+        state.head = 0;
+        state.rejects = 0;
+    }
+}
+
+uint8_t UWBRangeFilter::apply(int track, float* distances, uint8_t mask, unsigned long now) {
+    if (track < 0 || track >= _tracks) return mask;
+    State* states = &_states[track * ANCHORS];
+    uint8_t kept = mask;
+    uint8_t pending = mask;
+    while (pending != 0) {
+        int i = __builtin_ctz(pending);
+        pending &= pending - 1;
+        if (distances[i] <= 0) continue;
+
+        if (!filterRange(states[i], distances[i], now)) {
+            distances[i] = 0;
+            kept &= ~(1 << i);
+            _gated++;
+        }
+    }
+    return kept;
+}
+
+bool UWBRangeFilter::filterRange(State& state, float& range, unsigned long now) {
+    if (state.count > 0 && now - state.stamp > RESET_GAP) {
+        state.count = 0;
+        state.head = 0;
+        state.rejects = 0;
+    }
+
+    // Rate gate against the last output
+    if (_maxSpeed > 0 && state.count > 0) {
+        float allowed = _maxSpeed * (now - state.stamp) / 1000.0f + GATE_MARGIN;
+        if (fabsf(range - state.output) > allowed) {
+            if (++state.rejects < MAX_GATE_REJECTS) {
+                return false;
+            }
+            // The range really moved: start over from here
+            state.count = 0;
+            state.head = 0;
+        }
+    }
+    state.rejects = 0;
+
+    // Window of whole-cm ranges
+    float cm = range + 0.5f;
+    state.window[state.head] = (cm >= 65535.0f) ? 65535 : (uint16_t)cm;
+    state.head = (state.head + 1) % _window;
+    if (state.count < _window) state.count++;
+
+    float value = range;
+    if (_type != RANGE_FILTER_NONE && state.count >= 3) {
+        float median = windowMedian(state);
+        if (_type == RANGE_FILTER_MEDIAN) {
+            value = median;
+        } else {
+            // Hampel: only ranges far outside the window's spread are replaced
+            float deviations[MAX_WINDOW];
+            for (int i = 0; i < state.count; i++) {
+                deviations[i] = fabsf(state.window[i] - median);
+            }
+            sortSmall(deviations, state.count);
+            float threshold = HAMPEL_K * MAD_SCALE * sortedMedian(deviations, state.count);
+            if (threshold < HAMPEL_MIN) threshold = HAMPEL_MIN;
+            if (fabsf(range - median) > threshold) {
+                value = median;
+            }
+        }
+    }
+
+    // Smoothing starts from the first value after a (re)start
+    if (_alpha > 0 && state.count > 1) {
+        value = state.output + _alpha * (value - state.output);
+    }
+
+    state.output = value;
+    state.stamp = now;
+    range = value;
+    return true;
+}
+
+float UWBRangeFilter::windowMedian(const State& state) const {
+    float sorted[MAX_WINDOW];
+    for (int i = 0; i < state.count; i++) {
+        sorted[i] = state.window[i];
+    }
+    sortSmall(sorted, state.count);
+    return sortedMedian(sorted, state.count);
+}
+
+unsigned long UWBRangeFilter::getMemoryBytes() const {
+    return sizeof(*this) + (unsigned long)_tracks * ANCHORS * sizeof(State);
+}
@@ -0,0 +1,79 @@
+#ifndef UWB_RANGE_FILTER_H
+#define UWB_RANGE_FILTER_H
+
+#include <stdint.h>
+
+// Streaming range prefilter between the AT+RANGE parser and the solver.
+// Each tag (track) keeps a small fixed state per anchor, so the cost per
+// range is bounded by the window size (at most 7) and no memory is
+// allocated after construction. Per range, in order:
+//
+//   1. Rate gate: a range that moved further than maxSpeed allows since the
+//      last one is dropped (the anchor counts as missing for that report).
+//      After MAX_GATE_REJECTS drops in a row the filter restarts from the
+//      new value, so a real jump is only delayed, never locked out.
+//   2. Sliding window over the last ranges: RANGE_FILTER_MEDIAN outputs the
+//      window median; RANGE_FILTER_HAMPEL replaces only ranges that are
+//      more than HAMPEL_K scaled MADs from the median (at least HAMPEL_MIN)
+//      and passes the others through without lag.
+//   3. Optional exponential smoothing of the result.
+//
+// A gap of RESET_GAP restarts an anchor's state. Tracks are indexed by the
+// owner's tag table slot (like UWBLinkStats).
+
+enum RangeFilterType {
+    RANGE_FILTER_NONE,      // Gate and smoothing only
+    RANGE_FILTER_MEDIAN,
+    RANGE_FILTER_HAMPEL
+};
+
+class UWBRangeFilter {
+public:
+    static const int ANCHORS = 8;
+    static const int MAX_WINDOW = 7;
+    static const int MAX_GATE_REJECTS = 3;
+    static const unsigned long RESET_GAP = 2000;    // ms
+    static const float GATE_MARGIN;                 // cm allowed on top of maxSpeed * dt (range noise)
+    static const float HAMPEL_K;                    // Outlier threshold in scaled MADs
+    static const float HAMPEL_MIN;                  // cm, smallest outlier threshold
+
+    explicit UWBRangeFilter(int tracks);
+    ~UWBRangeFilter();
+
+    void setType(RangeFilterType type, int window);  // window: odd, 3..MAX_WINDOW
+    void setGate(float maxSpeed);                    // cm/s, 0 = off
+    void setSmoothing(float alpha);                  // 0..1 weight of a new range, 0 = off
+    RangeFilterType getType() const { return _type; }
+
+    // Filter one report's ranges (cm, by anchor ID) in place. Returns mask
+    // without the anchors the gate dropped; their distances are set to 0.
+    uint8_t apply(int track, float* distances, uint8_t mask, unsigned long now);
+    void clear(int track);
+
+    int getTracks() const { return _tracks; }
+    uint32_t getGated() const { return _gated; }    // Ranges dropped by the gate
+    unsigned long getMemoryBytes() const;
+
+private:
+    struct State {
+        uint16_t window[MAX_WINDOW];  // Whole cm, ring
+        float output;                 // Last output (and the smoothing state)
+        uint32_t stamp;               // millis() of the last accepted range
+        uint8_t count;                // Ranges in the window, 0 = no state
+        uint8_t head;                 // Next ring slot
+        uint8_t rejects;              // Consecutive gated ranges
+    };
+
+    bool filterRange(State& state, float& range, unsigned long now);
+    float windowMedian(const State& state) const;
+
+    State* _states;       // ANCHORS per track
+    int _tracks;
+    RangeFilterType _type;
+    int _window;
+    float _maxSpeed;
+    float _alpha;
+    uint32_t _gated;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "UWBScheduler.h"
+#include "UWBMemory.h"
+
+UWBScheduler::UWBScheduler(unsigned long (*clockMicros)()) {
+    _clock = clockMicros;
+    _passBudget = DEFAULT_PASS_BUDGET;
+    for (int i = 0; i < TASK_COUNT; i++) {
+        _tasks[i].name = "";
+        _tasks[i].function = nullptr;
+        _tasks[i].context = nullptr;
+        _tasks[i].period = 0;
+        _tasks[i].budget = 0;
+        _tasks[i].lastRun = 0;
+        _tasks[i].priority = 0;
+        _tasks[i].enabled = false;
+        _order[i] = i;
+    }
+    resetStats();
+}
+
+void UWBScheduler::setTask(int id, const char* name, UWBTaskFunction function, void* context,
+                           unsigned long periodMs, uint8_t priority, unsigned long budgetMs) {
+    if (!validId(id)) return;
+
+    Task& task = _tasks[id];
+    task.name = name;
+    task.function = function;
+    task.context = context;
+    task.period = periodMs * 1000UL;
+    task.budget = budgetMs * 1000UL;
+    task.priority = priority;
+    task.enabled = (function != nullptr);
+    task.lastRun = _clock() - task.period; // Due on the first pass
+
+    // Keep the run order sorted by priority (insertion sort, TASK_COUNT is small)
+    for (int i = 0; i < TASK_COUNT; i++) _order[i] = i;
+    for (int i = 1; i < TASK_COUNT; i++) {
+        uint8_t current = _order[i];
+        int j = i - 1;
+        while (j >= 0 && _tasks[_order[j]].priority < _tasks[current].priority) {
+            _order[j + 1] = _order[j];
+            j--;
+        }
+        _order[j + 1] = current;
+    }
+}
+
+void UWBScheduler::setPeriod(int id, unsigned long periodMs) {
+    if (validId(id)) _tasks[id].period = periodMs * 1000UL;
+}
+
+void UWBScheduler::setBudget(int id, unsigned long budgetMs) {
+    if (validId(id)) _tasks[id].budget = budgetMs * 1000UL;
+}
+
+void UWBScheduler::setEnabled(int id, bool enabled) {
+    if (validId(id)) _tasks[id].enabled = enabled && _tasks[id].function != nullptr;
+}
+
+void UWBScheduler::setPassBudget(unsigned long budgetUs) {
+    _passBudget = budgetUs;
+}
+
+void UWBScheduler::execute(Task& task, unsigned long now) {
+    int bucket = uwbAllocSetBucket((int)(&task - _tasks));
+    task.function(task.context);
+    uwbAllocSetBucket(bucket);
+    unsigned long end = _clock();
+    unsigned long elapsed = end - now;
+
+    task.lastTime = elapsed;
+    if (elapsed > task.maxTime) task.maxTime = elapsed;
+    if (task.budget > 0 && elapsed > task.budget) task.overruns++;
+    task.runs++;
+}
+
+void UWBScheduler::runContinuous(unsigned long& now) {
+    for (int n = 0; n < TASK_COUNT; n++) {
+        Task& task = _tasks[_order[n]];
+        if (task.enabled && task.period == 0) {
+            execute(task, now);
+            task.lastRun = now;
+            now = _clock();
+        }
+    }
+}
+
+void UWBScheduler::run() {
+    unsigned long passStart = _clock();
+    unsigned long now = passStart;
+    bool ranPeriodic = false;
+
+    runContinuous(now);
+
+    for (int n = 0; n < TASK_COUNT; n++) {
+        Task& task = _tasks[_order[n]];
+        if (!task.enabled || task.period == 0) continue;
+        if (now - task.lastRun < task.period) continue;
+
+        // The first due task always runs; later ones wait if the pass is spent
+        if (ranPeriodic && now - passStart > _passBudget) {
+            task.deferred++;
+            continue;
+        }
+
+        // Keep the schedule anchored to the period unless we fell far behind
+        if (now - task.lastRun < 2 * task.period) {
+            task.lastRun += task.period;
+        } else {
+            task.lastRun = now;
+        }
+        execute(task, now);
+        now = _clock();
+        ranPeriodic = true;
+
+        // Drain input that arrived while the slower task ran
+        runContinuous(now);
+    }
+}
+
+bool UWBScheduler::isEnabled(int id) const {
+    return validId(id) && _tasks[id].enabled;
+}
+
+const char* UWBScheduler::getName(int id) const {
+    return validId(id) ? _tasks[id].name : "";
+}
+
+unsigned long UWBScheduler::getPeriod(int id) const {
+    return validId(id) ? _tasks[id].period / 1000UL : 0;
+}
+
+uint32_t UWBScheduler::getRuns(int id) const {
+    return validId(id) ? _tasks[id].runs : 0;
+}
+
+uint32_t UWBScheduler::getOverruns(int id) const {
+    return validId(id) ? _tasks[id].overruns : 0;
+}
+
+uint32_t UWBScheduler::getDeferred(int id) const {
+    return validId(id) ? _tasks[id].deferred : 0;
+}
+
+unsigned long UWBScheduler::getMaxTime(int id) const {
+    return validId(id) ? _tasks[id].maxTime : 0;
+}
+
+unsigned long UWBScheduler::getLastTime(int id) const {
+    return validId(id) ? _tasks[id].lastTime : 0;
+}
+
+void UWBScheduler::resetStats() {
+    for (int i = 0; i < TASK_COUNT; i++) {
+        _tasks[i].lastTime = 0;
+        _tasks[i].maxTime = 0;
+        _tasks[i].runs = 0;
+        _tasks[i].overruns = 0;
+        _tasks[i].deferred = 0;
+    }
+}
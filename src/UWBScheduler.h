@@ -0,0 +1,88 @@
+#ifndef UWB_SCHEDULER_H
+#define UWB_SCHEDULER_H
+
+#include <stdint.h>
+
+// Subsystems that update() schedules on UWBTAG and UWBAnchor
+enum UWBTask {
+    TASK_INGEST,        // Read and parse module output (every update())
+    TASK_RANGING,       // Request ranging (tag)
+    TASK_SOLVE,         // Solve pending range reports
+    TASK_BROADCAST,     // Send ALLPOS (Position Server)
+    TASK_EXPIRY,        // Drop tags that went silent
+    TASK_DISPLAY,       // Redraw the OLED
+    TASK_TELEMETRY,     // Print link statistics (off by default)
+    TASK_LOGGER,        // Drain binary logger frames (Data Logger)
+    TASK_UPLOAD,        // Send own fixes to the Position Server (tag, off by default)
+    TASK_MEMORY,        // Sample heap and stack (off by default)
+    TASK_SYNC,          // Clock sync request to the Position Server (tag, off by default)
+    TASK_SURVEY,        // Anchor survey turn (anchor, on only during surveyTurn())
+    TASK_COUNT
+};
+
+typedef void (*UWBTaskFunction)(void* context);
+
+// Cooperative deadline scheduler. Each task has a period, a priority and
+// a time budget. run() executes the due tasks highest priority first,
+// runs the continuous (period 0) tasks again between the others so slow
+// work never starves them, and defers lower-priority work to the next
+// call once the pass budget is spent. A task that takes longer than its
+// budget is counted as an overrun. Heap allocations made by a task are
+// charged to it (see UWBMemory.h).
+class UWBScheduler {
+public:
+    static const unsigned long DEFAULT_PASS_BUDGET = 20000; // us per run()
+
+    // clockMicros: microsecond clock (micros() on Arduino)
+    explicit UWBScheduler(unsigned long (*clockMicros)());
+
+    // Register task id (an UWBTask value); period/budget in ms, period 0 = every pass
+    void setTask(int id, const char* name, UWBTaskFunction function, void* context,
+                 unsigned long periodMs, uint8_t priority, unsigned long budgetMs);
+    void setPeriod(int id, unsigned long periodMs);
+    void setBudget(int id, unsigned long budgetMs);
+    void setEnabled(int id, bool enabled);
+    void setPassBudget(unsigned long budgetUs);
+
+    // Run what is due
+    void run();
+
+    // Statistics
+    bool isEnabled(int id) const;
+    const char* getName(int id) const;
+    unsigned long getPeriod(int id) const;
+    uint32_t getRuns(int id) const;
+    uint32_t getOverruns(int id) const;
+    uint32_t getDeferred(int id) const;      // Passes a due task waited for budget
+    unsigned long getMaxTime(int id) const;  // us
+    unsigned long getLastTime(int id) const; // us
+    void resetStats();
+
+private:
+    struct Task {
+        const char* name;
+        UWBTaskFunction function;
+        void* context;
+        unsigned long period;      // us
+        unsigned long budget;      // us
+        unsigned long lastRun;     // us
+        unsigned long lastTime;    // us
+        unsigned long maxTime;     // us
+        uint32_t runs;
+        uint32_t overruns;
+        uint32_t deferred;
+        uint8_t priority;
+        bool enabled;
+    };
+
+    bool validId(int id) const { return id >= 0 && id < TASK_COUNT; }
+    void execute(Task& task, unsigned long now);
+    void runContinuous(unsigned long& now);
+
+    unsigned long (*_clock)();
+    Task _tasks[TASK_COUNT];
+    uint8_t _order[TASK_COUNT];    // Task IDs by descending priority
+    unsigned long _passBudget;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef UWB_SEQLOCK_H
+#define UWB_SEQLOCK_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Sequence lock for data written by one task (update()) and read from any
+// other task or core without ever blocking the writer. A reader copies the
+// data and retries if a write overlapped the copy:
+//
+//   uint32_t seq;
+//   do {
+//       seq = lock.readBegin();
+//       ...copy the fields...
+//   } while (lock.readRetry(seq));
+//
+// A reader spins while a write is in progress, so it must not run at a
+// higher priority than update() on the same core. Readers in the same task
+// as update() never retry.
+class UWBSeqLock {
+public:
+    UWBSeqLock() : _seq(0) {}
+
+    void writeBegin() {
+        _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void writeEnd() {
+        _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint32_t readBegin() const {
+        uint32_t seq;
+        while ((seq = _seq.load(std::memory_order_acquire)) & 1) {
+            // Odd: a write is in progress
+        }
+        return seq;
+    }
+
+    bool readRetry(uint32_t seq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _seq.load(std::memory_order_relaxed) != seq;
+    }
+
+private:
+    std::atomic<uint32_t> _seq;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include "UWBSite.h"
+
+const float UWBSite::ZONE_MARGIN = 50.0;
+
+UWBSite::UWBSite() {
+    _zoneCount = 0;
+    _activeSetSize = DEFAULT_ACTIVE_SET;
+    clear();
+}
+
+UWBSite::~UWBSite() {
+    clear();
+}
+
+int UWBSite::addZone(float x1, float y1, float x2, float y2) {
+    if (_zoneCount >= MAX_ANCHOR_ZONES) {
+        return -1;
+    }
+
+    Zone& zone = _zones[_zoneCount];
+    zone.minX = (x1 < x2) ? x1 : x2;
+    zone.maxX = (x1 < x2) ? x2 : x1;
+    zone.minY = (y1 < y2) ? y1 : y2;
+    zone.maxY = (y1 < y2) ? y2 : y1;
+    zone.anchors = 0;
+    zone.neighbours = 0;
+    zone.solver = new UWBSolver();
+
+    // Adjacency is fixed by the rectangles, so it is worked out once here
+    for (int i = 0; i < _zoneCount; i++) {
+        if (touches(i, _zoneCount)) {
+            _zones[i].neighbours |= (1 << _zoneCount);
+            zone.neighbours |= (1 << i);
+        }
+    }
+    return _zoneCount++;
+}
+
+bool UWBSite::addAnchor(int zone, int anchorID, float x, float y) {
+    if (zone < 0 || zone >= _zoneCount || anchorID < 0 || anchorID >= UWBSolver::MAX_ANCHORS) {
+        return false;
+    }
+    _zones[zone].solver->setAnchor(anchorID, x, y);
+    _zones[zone].anchors |= (1 << anchorID);
+    return true;
+}
+
+void UWBSite::clear() {
+    for (int i = 0; i < _zoneCount; i++) {
+        delete _zones[i].solver;
+    }
+    _zoneCount = 0;
+    _activeZone = -1;
+    _rescanWait = 0;
+    _activeSet = 0;
+    _rejected = 0;
+}
+
+uint16_t UWBSite::getNeighbours(int zone) const {
+    return (zone >= 0 && zone < _zoneCount) ? _zones[zone].neighbours : 0;
+}
+
+void UWBSite::setActiveSetSize(int count) {
+    if (count < 3) count = 3;
+    if (count > UWBSolver::MAX_ANCHORS) count = UWBSolver::MAX_ANCHORS;
+    _activeSetSize = count;
+}
+
+void UWBSite::setActiveZone(int zone) {
+    _activeZone = (zone >= 0 && zone < _zoneCount) ? zone : -1;
+    _rescanWait = 0;
+}
+
+bool UWBSite::inside(int zone, float x, float y, float margin) const {
+    const Zone& z = _zones[zone];
+    return x >= z.minX - margin && x <= z.maxX + margin &&
+           y >= z.minY - margin && y <= z.maxY + margin;
+}
+
+bool UWBSite::touches(int a, int b) const {
+    // A fix may stray ZONE_MARGIN out of its zone, so zones that close count
+    const Zone& za = _zones[a];
+    const Zone& zb = _zones[b];
+    return za.minX <= zb.maxX + ZONE_MARGIN && zb.minX <= za.maxX + ZONE_MARGIN &&
+           za.minY <= zb.maxY + ZONE_MARGIN && zb.minY <= za.maxY + ZONE_MARGIN;
+}
+
+uint8_t UWBSite::nearest(int zone, const float* distances, uint8_t mask) const {
+    // Shortest ranges first; with at most 8 candidates a selection pass is enough
+    uint8_t candidates = mask & _zones[zone].anchors;
+    uint8_t set = 0;
+    for (int n = 0; n < _activeSetSize; n++) {
+        int best = -1;
+        uint8_t pending = candidates;
+        while (pending != 0) {
+            int i = __builtin_ctz(pending);
+            pending &= pending - 1;
+            if (distances[i] <= 0) continue;
+            if (best < 0 || distances[i] < distances[best]) best = i;
+        }
+        if (best < 0) break;
+        set |= (1 << best);
+        candidates &= ~(1 << best);
+    }
+    return set;
+}
+
+bool UWBSite::solveIn(const UWBSolver& settings, int zone, const float* distances, uint8_t mask,
+                      const float* weights, float& x, float& y, bool warmStart, float& fit,
+                      uint8_t& set, uint8_t& rejected) const {
+    UWBSolver& solver = *_zones[zone].solver;
+    solver.copySettings(settings);
+    set = nearest(zone, distances, mask);
+    float fixX = x, fixY = y;
+    if (!solver.solve(distances, set, weights, fixX, fixY, warmStart, &rejected)) {
+        return false;
+    }
+
+    // Ranges from same-ID anchors of another zone do not fit this one
+    // (outliers the solver left out do not count against the zone)
+    fit = solver.residual(distances, set & ~rejected, fixX, fixY);
+    if (fit < 0 || fit > UWBSolver::MAX_RESIDUAL) {
+        return false;
+    }
+    x = fixX;
+    y = fixY;
+    return true;
+}
+
+bool UWBSite::scan(const UWBSolver& settings, uint16_t zones, const float* distances, uint8_t mask,
+                   const float* weights, float& x, float& y, bool warmStart) {
+    // The zones whose own anchors fit the ranges and put the fix inside
+    // them. Zones reusing the same IDs fit equally well, so with a recent
+    // fix the nearest candidate wins, otherwise the best fit.
+    int bestZone = -1;
+    float bestScore = 0.0;
+    float bestX = 0.0, bestY = 0.0;
+    uint8_t bestSet = 0, bestRejected = 0;
+    while (zones != 0) {
+        int z = __builtin_ctz(zones);
+        zones &= zones - 1;
+        float zoneX = x, zoneY = y;
+        float fit;
+        uint8_t set, rejected;
+        if (!solveIn(settings, z, distances, mask, weights, zoneX, zoneY, false, fit, set, rejected) ||
+            !inside(z, zoneX, zoneY, 0)) {
+            continue;
+        }
+        float score = fit;
+        if (warmStart) {
+            score = (zoneX - x) * (zoneX - x) + (zoneY - y) * (zoneY - y);
+        }
+        if (bestZone < 0 || score < bestScore) {
+            bestZone = z;
+            bestScore = score;
+            bestX = zoneX;
+            bestY = zoneY;
+            bestSet = set;
+            bestRejected = rejected;
+        }
+    }
+    if (bestZone < 0) {
+        return false;
+    }
+
+    _activeZone = bestZone;
+    _activeSet = bestSet;
+    _rejected = bestRejected;
+    x = bestX;
+    y = bestY;
+    return true;
+}
+
+bool UWBSite::solve(const UWBSolver& solver, const float* distances, uint8_t mask, const float* weights,
+                    float& x, float& y, bool warmStart) {
+    if (_zoneCount == 0) {
+        return false;
+    }
+
+    // Steady state: stay in the active zone while the fix is (nearly) inside it
+    uint16_t remaining = (uint16_t)((1UL << _zoneCount) - 1);
+    if (_activeZone >= 0) {
+        float fixX = x, fixY = y;
+        float fit;
+        uint8_t set, rejected;
+        if (solveIn(solver, _activeZone, distances, mask, weights, fixX, fixY, warmStart, fit, set, rejected) &&
+            inside(_activeZone, fixX, fixY, ZONE_MARGIN)) {
+            _activeSet = set;
+            _rejected = rejected;
+            x = fixX;
+            y = fixY;
+            return true;
+        }
+
+        // Moved on: a tag walks into a neighbouring zone
+        uint16_t neighbours = _zones[_activeZone].neighbours;
+        if (scan(solver, neighbours, distances, mask, weights, x, y, warmStart)) {
+            _rescanWait = 0;
+            return true;
+        }
+        remaining &= ~(neighbours | (1 << _activeZone));
+    }
+
+    // Lost (or first fix): every other zone, at most once per RESCAN_INTERVAL solves
+    if (remaining == 0) {
+        return false;
+    }
+    if (_rescanWait > 0) {
+        _rescanWait--;
+        return false;
+    }
+    if (scan(solver, remaining, distances, mask, weights, x, y, warmStart)) {
+        return true;
+    }
+    _rescanWait = RESCAN_INTERVAL;
+    return false;
+}
+
+float UWBSite::residual(const float* distances, uint8_t mask, float x, float y) const {
+    if (_activeZone < 0) {
+        return -1.0;
+    }
+    return _zones[_activeZone].solver->residual(distances, mask, x, y);
+}
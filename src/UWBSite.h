@@ -0,0 +1,86 @@
+#ifndef UWB_SITE_H
+#define UWB_SITE_H
+
+#include <stdint.h>
+#include "UWBSolver.h"
+
+// Anchor layout for sites larger than one set of anchors (corridors,
+// multi-room floors). The site is split into rectangular anchor zones,
+// each with up to 8 anchors. Within a zone the anchors are addressed by
+// their module IDs 0-7, so IDs can be reused in zones far enough apart.
+//
+// Each tag keeps one active zone (the one its last fix fell in) and
+// solves only against the nearest anchors of that zone, so per-fix cost
+// does not depend on how many zones the site has. When a fix leaves the
+// active zone only its neighbours (zones within ZONE_MARGIN of it) are
+// tried; the other zones are scanned only if none of them fits, and a
+// scan that finds nothing waits RESCAN_INTERVAL solves before the next.
+// Each zone keeps its own solver, so its triangle table is built once
+// (about 2 KB per zone, allocated by addZone()).
+class UWBSite {
+public:
+    static const int MAX_ANCHOR_ZONES = 16;
+    static const int DEFAULT_ACTIVE_SET = 4;
+    static const int RESCAN_INTERVAL = 10;   // Solves skipped after a full scan found no zone
+    static const float ZONE_MARGIN;   // cm a fix may stray outside its zone before switching
+
+    UWBSite();
+    ~UWBSite();
+    UWBSite(const UWBSite&) = delete;            // Owns the zone solvers
+    UWBSite& operator=(const UWBSite&) = delete;
+
+    // Layout (returns zone index, or -1 if full)
+    int addZone(float x1, float y1, float x2, float y2);
+    bool addAnchor(int zone, int anchorID, float x, float y);
+    void clear();
+    int zoneCount() const { return _zoneCount; }
+    uint16_t getNeighbours(int zone) const;   // Bit per zone touching it
+
+    // Anchors per solve: the nearest reporting anchors of the active zone (3-8)
+    void setActiveSetSize(int count);
+
+    // Seed the active zone. Zones that reuse the same anchor IDs fit a
+    // first fix equally well, so with reuse the start zone should be set.
+    void setActiveZone(int zone);
+    int getActiveZone() const { return _activeZone; }
+    uint8_t getActiveSet() const { return _activeSet; }
+    uint8_t getRejected() const { return _rejected; }   // Outlier anchors left out of the last fix
+
+    // Solve with the active zone's anchors, using the refinement and
+    // outlier settings of solver (x/y in/out as for UWBSolver's warm-start
+    // solve). Switches zone when the fix lands in another one; returns
+    // false if the fix is in no zone.
+    bool solve(const UWBSolver& solver, const float* distances, uint8_t mask, const float* weights,
+               float& x, float& y, bool warmStart);
+
+    // RMS (cm) of range residuals against the active zone's anchors, as
+    // UWBSolver::residual(); -1 before the first fix
+    float residual(const float* distances, uint8_t mask, float x, float y) const;
+
+private:
+    struct Zone {
+        float minX, minY, maxX, maxY;
+        uint8_t anchors;      // Configured anchor IDs
+        uint16_t neighbours;  // Zones within ZONE_MARGIN
+        UWBSolver* solver;    // This zone's anchors and triangle table
+    };
+
+    bool inside(int zone, float x, float y, float margin) const;
+    bool touches(int a, int b) const;
+    uint8_t nearest(int zone, const float* distances, uint8_t mask) const;
+    bool solveIn(const UWBSolver& settings, int zone, const float* distances, uint8_t mask,
+                 const float* weights, float& x, float& y, bool warmStart, float& fit,
+                 uint8_t& set, uint8_t& rejected) const;
+    bool scan(const UWBSolver& settings, uint16_t zones, const float* distances, uint8_t mask,
+              const float* weights, float& x, float& y, bool warmStart);
+
+    Zone _zones[MAX_ANCHOR_ZONES];
+    int _zoneCount;
+    int _activeZone;      // -1 until the first fix
+    int _activeSetSize;
+    int _rescanWait;      // Solves left before the next full scan
+    uint8_t _activeSet;
+    uint8_t _rejected;
+};
+
+#endif
@@ -0,0 +1,409 @@
+#include "UWBSolver.h"
+#include <cmath> // Include for sqrt() and abs() functions
+
+const float UWBSolver::RSSI_STRONG = -75.0;
+const float UWBSolver::RSSI_WEAK = -95.0;
+const float UWBSolver::MAX_RESIDUAL = 30.0;
+const float UWBSolver::MAX_TRIANGLE_DOP = 6.0;
+
+UWBSolver::UWBSolver() {
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        _anchorX[i] = 0.0;
+        _anchorY[i] = 0.0;
+        _configured[i] = false;
+    }
+    _configuredMask = 0;
+    _maxIterations = 0;
+    _tolerance = 1.0;
+    _outlierThreshold = 0.0;
+    _maxRejects = 1;
+    _triangleCount = 0;
+}
+
+void UWBSolver::setAnchor(int anchorID, float x, float y) {
+    if (anchorID >= 0 && anchorID < MAX_ANCHORS) {
+        _anchorX[anchorID] = x;
+        _anchorY[anchorID] = y;
+        _configured[anchorID] = true;
+        _configuredMask |= (1 << anchorID);
+        buildTriangles();
+    }
+}
+
+void UWBSolver::clearAnchor(int anchorID) {
+    if (anchorID >= 0 && anchorID < MAX_ANCHORS) {
+        _configured[anchorID] = false;
+        _configuredMask &= ~(1 << anchorID);
+        buildTriangles();
+    }
+}
+
+void UWBSolver::setAnchors(const float* xs, const float* ys, uint8_t mask) {
+    // One table rebuild for the whole layout
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        _configured[i] = (mask & (1 << i)) != 0;
+        _anchorX[i] = _configured[i] ? xs[i] : 0.0;
+        _anchorY[i] = _configured[i] ? ys[i] : 0.0;
+    }
+    _configuredMask = mask;
+    buildTriangles();
+}
+
+bool UWBSolver::isAnchorConfigured(int anchorID) const {
+    return anchorID >= 0 && anchorID < MAX_ANCHORS && _configured[anchorID];
+}
+
+float UWBSolver::getAnchorX(int anchorID) const {
+    return isAnchorConfigured(anchorID) ? _anchorX[anchorID] : 0.0;
+}
+
+float UWBSolver::getAnchorY(int anchorID) const {
+    return isAnchorConfigured(anchorID) ? _anchorY[anchorID] : 0.0;
+}
+
+void UWBSolver::buildTriangles() {
+    // Score every triangle of configured anchors once, so solves only
+    // filter the table by which anchors reported
+    _triangleCount = 0;
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        for (int j = i + 1; j < MAX_ANCHORS; j++) {
+            for (int k = j + 1; k < MAX_ANCHORS; k++) {
+                if (!_configured[i] || !_configured[j] || !_configured[k]) continue;
+
+                // Metres for numerical stability
+                float x1 = _anchorX[i] / 100.0, y1 = _anchorY[i] / 100.0;
+                float x2 = _anchorX[j] / 100.0, y2 = _anchorY[j] / 100.0;
+                float x3 = _anchorX[k] / 100.0, y3 = _anchorY[k] / 100.0;
+
+                Triangle t;
+                t.A = 2 * (x2 - x1);
+                t.B = 2 * (y2 - y1);
+                t.D = 2 * (x3 - x2);
+                t.E = 2 * (y3 - y2);
+                float det = t.A * t.E - t.B * t.D;     // 8x the triangle's area
+                if (std::abs(det) < 0.000001) continue; // Collinear
+
+                // DOP from shape: sum of squared sides over area, scaled so
+                // an equilateral triangle scores 1
+                float sides = (x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1) +
+                              (x3 - x2) * (x3 - x2) + (y3 - y2) * (y3 - y2) +
+                              (x1 - x3) * (x1 - x3) + (y1 - y3) * (y1 - y3);
+                float area = std::abs(det) / 8.0;
+                t.dop = sides / (4.0 * std::sqrt(3.0) * area);
+
+                t.K1 = -x1 * x1 + x2 * x2 - y1 * y1 + y2 * y2;
+                t.K2 = -x2 * x2 + x3 * x3 - y2 * y2 + y3 * y3;
+                t.inverseDet = 1.0 / det;
+                t.a = i;
+                t.b = j;
+                t.c = k;
+                t.mask = (1 << i) | (1 << j) | (1 << k);
+
+                // Insertion sort, best DOP first
+                int pos = _triangleCount++;
+                while (pos > 0 && _triangles[pos - 1].dop > t.dop) {
+                    _triangles[pos] = _triangles[pos - 1];
+                    pos--;
+                }
+                _triangles[pos] = t;
+            }
+        }
+    }
+}
+
+float UWBSolver::getBestDOP(uint8_t mask) const {
+    for (int i = 0; i < _triangleCount; i++) {
+        if ((_triangles[i].mask & mask) == _triangles[i].mask) {
+            return _triangles[i].dop;
+        }
+    }
+    return 0.0;
+}
+
+void UWBSolver::setOutlierRejection(float threshold, int maxRejects) {
+    _outlierThreshold = (threshold > 0) ? threshold : 0.0;
+    if (maxRejects < 1) maxRejects = 1;
+    if (maxRejects > MAX_ANCHORS - 3) maxRejects = MAX_ANCHORS - 3;
+    _maxRejects = maxRejects;
+}
+
+void UWBSolver::setRefinement(int maxIterations, float tolerance) {
+    _maxIterations = (maxIterations < 0) ? 0 : maxIterations;
+    _tolerance = (tolerance > 0) ? tolerance : 1.0;
+}
+
+void UWBSolver::copySettings(const UWBSolver& other) {
+    _maxIterations = other._maxIterations;
+    _tolerance = other._tolerance;
+    _outlierThreshold = other._outlierThreshold;
+    _maxRejects = other._maxRejects;
+}
+
+float UWBSolver::rssiWeight(float rssi) {
+    if (rssi == 0 || rssi >= RSSI_STRONG) return 1.0;
+    if (rssi <= RSSI_WEAK) return 0.1;
+    return 0.1 + 0.9 * (rssi - RSSI_WEAK) / (RSSI_STRONG - RSSI_WEAK);
+}
+
+bool UWBSolver::solve(const float* distances, float& x, float& y) const {
+    uint8_t mask = 0;
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        if (distances[i] > 0) mask |= (1 << i);
+    }
+    return solve(distances, mask, nullptr, x, y);
+}
+
+bool UWBSolver::solve(const float* distances, uint8_t mask, const float* weights, float& x, float& y) const {
+    // Anchors that answered and are configured; squared ranges in metres
+    float rangeSquared[MAX_ANCHORS];
+    uint8_t usable = 0;
+    uint8_t pending = mask & _configuredMask;
+    while (pending != 0) {
+        int i = __builtin_ctz(pending);
+        pending &= pending - 1;
+        if (distances[i] <= 0) continue;
+
+        float r = distances[i] / 100.0;
+        rangeSquared[i] = r * r;
+        usable |= (1 << i);
+    }
+
+    // Walk the precomputed triangles best-first, keeping those fully covered.
+    // Poorly conditioned ones are only used when nothing better reported.
+    float x_sum = 0.0;
+    float y_sum = 0.0;
+    float weightSum = 0.0;
+    int used = 0;
+
+    for (int n = 0; n < _triangleCount && used < MAX_TRIANGLES; n++) {
+        const Triangle& t = _triangles[n];
+        if ((t.mask & usable) != t.mask) continue;
+        if (used > 0 && t.dop > MAX_TRIANGLE_DOP) break;
+
+        float C = rangeSquared[t.a] - rangeSquared[t.b] + t.K1;
+        float F = rangeSquared[t.b] - rangeSquared[t.c] + t.K2;
+
+        float w = 1.0 / (t.dop * t.dop);
+        if (weights != nullptr) {
+            float link = weights[t.a];
+            if (weights[t.b] < link) link = weights[t.b];
+            if (weights[t.c] < link) link = weights[t.c];
+            w *= link;
+        }
+
+        x_sum += w * (C * t.E - F * t.B) * t.inverseDet;
+        y_sum += w * (t.A * F - C * t.D) * t.inverseDet;
+        weightSum += w;
+        used++;
+    }
+
+    if (weightSum <= 0) {
+        return false;
+    }
+
+    // Convert back to cm
+    x = (x_sum / weightSum) * 100.0;
+    y = (y_sum / weightSum) * 100.0;
+    return true;
+}
+
+float UWBSolver::residual(const float* distances, uint8_t mask, float x, float y) const {
+    float sum = 0.0;
+    int count = 0;
+    uint8_t pending = mask & _configuredMask;
+    while (pending != 0) {
+        int i = __builtin_ctz(pending);
+        pending &= pending - 1;
+        if (distances[i] <= 0) continue;
+
+        float dx = x - _anchorX[i];
+        float dy = y - _anchorY[i];
+        float r = std::sqrt(dx * dx + dy * dy) - distances[i];
+        sum += r * r;
+        count++;
+    }
+    return (count < 3) ? -1.0 : std::sqrt(sum / count);
+}
+
+int UWBSolver::refine(const float* distances, uint8_t mask, const float* weights, float& x, float& y) const {
+    // Gather usable anchors (metres, like the closed-form solve)
+    int anchorCount = 0;
+    float ranges[MAX_ANCHORS];
+    float anchorX[MAX_ANCHORS], anchorY[MAX_ANCHORS];
+    float anchorWeight[MAX_ANCHORS];
+
+    uint8_t usable = mask & _configuredMask;
+    while (usable != 0) {
+        int i = __builtin_ctz(usable);
+        usable &= usable - 1;
+        if (distances[i] <= 0) continue;
+
+        ranges[anchorCount] = distances[i] / 100.0;
+        anchorX[anchorCount] = _anchorX[i] / 100.0;
+        anchorY[anchorCount] = _anchorY[i] / 100.0;
+        anchorWeight[anchorCount] = (weights != nullptr) ? weights[i] : 1.0;
+        anchorCount++;
+    }
+    if (anchorCount < 3) {
+        return -1;
+    }
+
+    float px = x / 100.0;
+    float py = y / 100.0;
+    float tolerance = _tolerance / 100.0;
+    int iterations = 0;
+    float residualSum = 0.0;
+    float weightSum = 0.0;
+
+    while (true) {
+        // Normal equations J'WJ * step = -J'Wr for residual r = |p - a| - range
+        float jxx = 0.0, jxy = 0.0, jyy = 0.0;
+        float gx = 0.0, gy = 0.0;
+        float minDist = 1.0e9;
+        residualSum = 0.0;
+        weightSum = 0.0;
+
+        for (int i = 0; i < anchorCount; i++) {
+            float dx = px - anchorX[i];
+            float dy = py - anchorY[i];
+            float dist = std::sqrt(dx * dx + dy * dy);
+            if (dist < 0.001) dist = 0.001; // On top of an anchor
+            if (dist < minDist) minDist = dist;
+            float inverse = 1.0 / dist;
+            float ux = dx * inverse;
+            float uy = dy * inverse;
+            float r = dist - ranges[i];
+            float w = anchorWeight[i];
+
+            jxx += w * ux * ux;
+            jxy += w * ux * uy;
+            jyy += w * uy * uy;
+            gx += w * ux * r;
+            gy += w * uy * r;
+            residualSum += w * r * r;
+            weightSum += w;
+        }
+
+        // Stop once the last step was small enough or the budget is spent
+        if (iterations >= _maxIterations) break;
+
+        float det = jxx * jyy - jxy * jxy;
+        if (std::abs(det) < 0.000001) {
+            return -1; // Anchors (nearly) collinear as seen from here
+        }
+        float stepX = -(jyy * gx - jxy * gy) / det;
+        float stepY = -(jxx * gy - jxy * gx) / det;
+        px += stepX;
+        py += stepY;
+        iterations++;
+
+        // A step s leaves a linearisation error of about s^2 / distance,
+        // so a warm start a few cm off is already converged after one step
+        float step2 = stepX * stepX + stepY * stepY;
+        if (step2 < tolerance * tolerance || step2 / minDist < tolerance) {
+            break;
+        }
+    }
+
+    if (weightSum <= 0 || std::sqrt(residualSum / weightSum) * 100.0 > MAX_RESIDUAL) {
+        return -1;
+    }
+
+    x = px * 100.0;
+    y = py * 100.0;
+    return iterations;
+}
+
+bool UWBSolver::solveOnce(const float* distances, uint8_t mask, const float* weights,
+                          float& x, float& y, bool warmStart) const {
+    if (_maxIterations > 0 && warmStart) {
+        // Steady state: the previous fix is a few cm off, one or two steps
+        float warmX = x, warmY = y;
+        if (refine(distances, mask, weights, warmX, warmY) >= 0) {
+            x = warmX;
+            y = warmY;
+            return true;
+        }
+    }
+
+    // Cold start (or a warm start that did not fit): closed form first
+    float coldX, coldY;
+    if (!solve(distances, mask, weights, coldX, coldY)) {
+        return false;
+    }
+    if (_maxIterations > 0) {
+        // Polish the triangle average; keep it if refinement is rejected
+        refine(distances, mask, weights, coldX, coldY);
+    }
+    x = coldX;
+    y = coldY;
+    return true;
+}
+
+bool UWBSolver::solve(const float* distances, uint8_t mask, const float* weights,
+                      float& x, float& y, bool warmStart, uint8_t* rejected) const {
+    if (rejected != nullptr) *rejected = 0;
+    float fixX = x, fixY = y;
+    if (!solveOnce(distances, mask, weights, fixX, fixY, warmStart)) {
+        return false;
+    }
+    if (_outlierThreshold > 0) {
+        uint8_t dropped = rejectOutliers(distances, mask, weights, fixX, fixY);
+        if (rejected != nullptr) *rejected = dropped;
+    }
+    x = fixX;
+    y = fixY;
+    return true;
+}
+
+uint8_t UWBSolver::rejectOutliers(const float* distances, uint8_t mask, const float* weights,
+                                  float& x, float& y) const {
+    // Anchors that took part in the fix
+    uint8_t used = 0;
+    uint8_t pending = mask & _configuredMask;
+    while (pending != 0) {
+        int i = __builtin_ctz(pending);
+        pending &= pending - 1;
+        if (distances[i] > 0) used |= (1 << i);
+    }
+
+    float fit = residual(distances, used, x, y);
+    if (fit <= _outlierThreshold) {
+        return 0; // Fits (or too few anchors to tell)
+    }
+
+    // Leave one anchor out per round; the subset that fits best goes on
+    uint8_t kept = used;
+    float keptX = x, keptY = y;
+    for (int round = 0; round < _maxRejects && __builtin_popcount(kept) > 3; round++) {
+        uint8_t bestSet = 0;
+        float bestFit = 0.0, bestX = 0.0, bestY = 0.0;
+        pending = kept;
+        while (pending != 0) {
+            int i = __builtin_ctz(pending);
+            pending &= pending - 1;
+
+            uint8_t subset = kept & ~(1 << i);
+            float subsetX = keptX, subsetY = keptY;
+            if (!solveOnce(distances, subset, weights, subsetX, subsetY, false)) continue;
+            float subsetFit = residual(distances, subset, subsetX, subsetY);
+            if (subsetFit >= 0 && (bestSet == 0 || subsetFit < bestFit)) {
+                bestSet = subset;
+                bestFit = subsetFit;
+                bestX = subsetX;
+                bestY = subsetY;
+            }
+        }
+        if (bestSet == 0) break;
+
+        kept = bestSet;
+        keptX = bestX;
+        keptY = bestY;
+        if (bestFit <= _outlierThreshold) {
+            x = keptX;
+            y = keptY;
+            return used & ~kept;
+        }
+    }
+    return 0; // No subset explains the ranges: keep the fix from every anchor
+}
@@ -0,0 +1,116 @@
+#ifndef UWB_SOLVER_H
+#define UWB_SOLVER_H
+
+#include <stdint.h>
+
+// Position solver shared by the Position Server anchor and the host-side
+// tools. Plain C++ with no Arduino dependencies so the same code runs on
+// the ESP32 and on a Linux box.
+class UWBSolver {
+public:
+    static const int MAX_ANCHORS = 8;
+    static const int MAX_TRIANGLES = 10;  // Safety limit on combinations
+    static const int MAX_SUBSETS = 56;    // Anchor triangles out of MAX_ANCHORS
+    static const float MAX_TRIANGLE_DOP;  // Flatter triangles only used as a last resort
+    static const float RSSI_STRONG;       // dBm at or above which weight is 1
+    static const float RSSI_WEAK;         // dBm at or below which weight is 0.1
+
+    UWBSolver();
+
+    // Anchor layout (cm)
+    void setAnchor(int anchorID, float x, float y);
+    void clearAnchor(int anchorID);
+    void setAnchors(const float* xs, const float* ys, uint8_t mask); // Replace the whole layout
+    bool isAnchorConfigured(int anchorID) const;
+    float getAnchorX(int anchorID) const;
+    float getAnchorY(int anchorID) const;
+
+    // Solve from distances (cm) indexed by anchor ID; <= 0 means missing.
+    // Averages the intersections of the best-conditioned anchor triangles
+    // among the anchors that reported (up to MAX_TRIANGLES, weighted by
+    // 1/DOP^2). Returns false if fewer than 3 usable anchors.
+    bool solve(const float* distances, float& x, float& y) const;
+
+    // Same, but only anchors whose bit is set in mask are visited. With
+    // weights (per anchor ID, may be nullptr) each triangle counts by the
+    // weakest of its three anchors.
+    bool solve(const float* distances, uint8_t mask, const float* weights, float& x, float& y) const;
+
+    // Map an RSSI reading (dBm, 0 = unknown) to a solve weight in 0.1..1
+    static float rssiWeight(float rssi);
+
+    // Gauss-Newton least-squares refinement. maxIterations bounds the
+    // worst-case cost per fix; iteration stops early once a step moves
+    // less than tolerance (cm). 0 iterations (default) disables it.
+    void setRefinement(int maxIterations, float tolerance = 1.0);
+    int getMaxIterations() const { return _maxIterations; }
+
+    // Refine x/y (cm, in/out) against the ranges. Returns the iterations
+    // used, or -1 if the geometry is degenerate or the result fits the
+    // ranges worse than MAX_RESIDUAL (x/y are then left unchanged).
+    int refine(const float* distances, uint8_t mask, const float* weights, float& x, float& y) const;
+
+    // Solve starting from the previous fix in x/y (cm, in/out) when
+    // warmStart is set: refine from it directly, and only fall back to the
+    // closed-form triangle average if that fails. Without refinement this
+    // is the plain triangle average. With outlier rejection on, rejected
+    // (if not nullptr) receives the anchors left out of the fix.
+    bool solve(const float* distances, uint8_t mask, const float* weights,
+               float& x, float& y, bool warmStart, uint8_t* rejected = nullptr) const;
+
+    // Outlier (NLOS) rejection for the warm-start solve. A fix that fits
+    // its ranges worse than threshold (cm RMS) is solved again leaving out
+    // each reporting anchor in turn, and the best-fitting subset is kept.
+    // Up to maxRejects rounds, at least 3 anchors always remain; if no
+    // subset fits within threshold the fix from every anchor stands.
+    // Worst case maxRejects * 8 extra solves per fix. 0 = off (default).
+    void setOutlierRejection(float threshold, int maxRejects = 1);
+    float getOutlierThreshold() const { return _outlierThreshold; }
+
+    // Take over another solver's refinement and outlier rejection settings
+    void copySettings(const UWBSolver& other);
+
+    static const float MAX_RESIDUAL;      // cm RMS; worse warm starts are rejected
+
+    // RMS (cm) of range residuals at x/y over the anchors in mask, or -1
+    // if fewer than 3 of them reported
+    float residual(const float* distances, uint8_t mask, float x, float y) const;
+
+    // Geometry table: usable triangles in the current layout and the best
+    // DOP available from a set of anchors (0 if no usable triangle)
+    int getTriangleCount() const { return _triangleCount; }
+    float getBestDOP(uint8_t mask) const;
+
+private:
+    // One anchor triangle, precomputed whenever the layout changes.
+    // Its intersection is x = (C*E - F*B) * inverseDet, y = (A*F - C*D) * inverseDet
+    // with C = ra^2 - rb^2 + K1 and F = rb^2 - rc^2 + K2 (metres).
+    struct Triangle {
+        uint8_t mask;         // Bits of its three anchors
+        uint8_t a, b, c;
+        float dop;            // 1 = equilateral, grows as the triangle flattens
+        float A, B, D, E;
+        float K1, K2;
+        float inverseDet;
+    };
+
+    void buildTriangles();
+    bool solveOnce(const float* distances, uint8_t mask, const float* weights,
+                   float& x, float& y, bool warmStart) const;
+    uint8_t rejectOutliers(const float* distances, uint8_t mask, const float* weights,
+                           float& x, float& y) const;
+
+
+    float _anchorX[MAX_ANCHORS];
+    float _anchorY[MAX_ANCHORS];
+    bool _configured[MAX_ANCHORS];
+    uint8_t _configuredMask;
+    int _maxIterations;
+    float _tolerance;
+    float _outlierThreshold;  // cm, 0 = off
+    int _maxRejects;
+    Triangle _triangles[MAX_SUBSETS];   // Sorted by DOP, best first
+    int _triangleCount;
+};
+
+#endif
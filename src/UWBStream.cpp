@@ -0,0 +1,254 @@
+#include "UWBStream.h"
+
+static void putU16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+}
+
+static void putU32(uint8_t* out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = (value >> 24) & 0xFF;
+}
+
+static uint16_t getU16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+uint16_t uwbCrc16(const uint8_t* data, int length) {
+    // CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+int encodeRangeRecord(const UWBRangeRecord& record, uint8_t* out) {
+    putU32(out, record.timestamp);
+    putU16(out + 4, record.tagID);
+    putU16(out + 6, record.seq);
+    out[8] = record.anchorID;
+    out[9] = record.mask;
+
+    int length = 10;
+    for (int i = 0; i < 8; i++) {
+        if (record.mask & (1 << i)) {
+            putU16(out + length, record.range[i]);
+            length += 2;
+        }
+    }
+    return length;
+}
+
+bool decodeRangeRecord(const uint8_t* data, int length, UWBRangeRecord& record) {
+    if (length < 10) return false;
+
+    record.timestamp = getU32(data);
+    record.tagID = getU16(data + 4);
+    record.seq = getU16(data + 6);
+    record.anchorID = data[8];
+    record.mask = data[9];
+
+    int offset = 10;
+    for (int i = 0; i < 8; i++) {
+        record.range[i] = 0;
+        if (record.mask & (1 << i)) {
+            if (offset + 2 > length) return false;
+            record.range[i] = getU16(data + offset);
+            offset += 2;
+        }
+    }
+    return offset == length;
+}
+
+int encodePositionRecord(const UWBPositionRecord& record, uint8_t* out) {
+    putU32(out, record.timestamp);
+    putU16(out + 4, record.tagID);
+    putU16(out + 6, record.seq);
+    putU32(out + 8, (uint32_t)record.x);
+    putU32(out + 12, (uint32_t)record.y);
+    putU16(out + 16, record.residual);
+    out[18] = record.mask;
+    out[19] = record.flags;
+    return POSITION_RECORD_SIZE;
+}
+
+bool decodePositionRecord(const uint8_t* data, int length, UWBPositionRecord& record) {
+    if (length != POSITION_RECORD_SIZE) return false;
+
+    record.timestamp = getU32(data);
+    record.tagID = getU16(data + 4);
+    record.seq = getU16(data + 6);
+    record.x = (int32_t)getU32(data + 8);
+    record.y = (int32_t)getU32(data + 12);
+    record.residual = getU16(data + 16);
+    record.mask = data[18];
+    record.flags = data[19];
+    return true;
+}
+
+// ==============================
+// UWBFrameQueue Implementation
+// ==============================
+
+UWBFrameQueue::UWBFrameQueue() {
+    _head = 0;
+    _count = 0;
+    _dropped = 0;
+    _queued = 0;
+}
+
+bool UWBFrameQueue::push(uint8_t type, const uint8_t* payload, int length) {
+    // Raw frame: type + payload + crc
+    uint8_t raw[UWB_MAX_FRAME];
+    if (length < 0 || length + 3 > UWB_MAX_FRAME - 2) {
+        _dropped++;
+        return false;
+    }
+    raw[0] = type;
+    for (int i = 0; i < length; i++) {
+        raw[1 + i] = payload[i];
+    }
+    int rawLength = length + 1;
+    putU16(raw + rawLength, uwbCrc16(raw, rawLength));
+    rawLength += 2;
+
+    // COBS encode, then terminate with the 0x00 delimiter
+    uint8_t encoded[UWB_MAX_FRAME];
+    int codeIndex = 0;
+    int out = 1;
+    uint8_t code = 1;
+    for (int i = 0; i < rawLength; i++) {
+        if (raw[i] == 0) {
+            encoded[codeIndex] = code;
+            codeIndex = out++;
+            code = 1;
+        } else {
+            encoded[out++] = raw[i];
+            code++;
+        }
+    }
+    encoded[codeIndex] = code;
+    encoded[out++] = 0x00;
+
+    // All or nothing - never block, never queue half a frame
+    if (out > CAPACITY - _count) {
+        _dropped++;
+        return false;
+    }
+
+    int tail = (_head + _count) % CAPACITY;
+    for (int i = 0; i < out; i++) {
+        _buffer[tail] = encoded[i];
+        tail = (tail + 1) % CAPACITY;
+    }
+    _count += out;
+    _queued++;
+    return true;
+}
+
+int UWBFrameQueue::peek(const uint8_t** data) const {
+    *data = &_buffer[_head];
+    int contiguous = CAPACITY - _head;
+    return (_count < contiguous) ? _count : contiguous;
+}
+
+void UWBFrameQueue::consume(int count) {
+    if (count > _count) count = _count;
+    _head = (_head + count) % CAPACITY;
+    _count -= count;
+}
+
+int UWBFrameQueue::used() const {
+    return _count;
+}
+
+uint32_t UWBFrameQueue::getDropped() const {
+    return _dropped;
+}
+
+uint32_t UWBFrameQueue::getQueued() const {
+    return _queued;
+}
+
+// ==============================
+// UWBFrameDecoder Implementation
+// ==============================
+
+UWBFrameDecoder::UWBFrameDecoder() {
+    _rawLength = 0;
+    _frameLength = 0;
+    _overflow = false;
+    _crcErrors = 0;
+}
+
+bool UWBFrameDecoder::feed(uint8_t byte) {
+    if (byte != 0x00) {
+        if (_rawLength < UWB_MAX_FRAME) {
+            _raw[_rawLength++] = byte;
+        } else {
+            _overflow = true;
+        }
+        return false;
+    }
+
+    // Delimiter: decode whatever was collected
+    int rawLength = _rawLength;
+    bool overflow = _overflow;
+    _rawLength = 0;
+    _overflow = false;
+    if (rawLength == 0) return false;
+    if (overflow) {
+        _crcErrors++;
+        return false;
+    }
+
+    int out = 0;
+    int i = 0;
+    while (i < rawLength) {
+        uint8_t code = _raw[i++];
+        if (code == 0 || i + code - 1 > rawLength) {
+            _crcErrors++;
+            return false;
+        }
+        for (int j = 1; j < code; j++) {
+            _frame[out++] = _raw[i++];
+        }
+        if (code < 0xFF && i < rawLength) {
+            _frame[out++] = 0x00;
+        }
+    }
+
+    if (out < 3 || uwbCrc16(_frame, out - 2) != getU16(_frame + out - 2)) {
+        _crcErrors++;
+        return false;
+    }
+
+    _frameLength = out - 2;
+    return true;
+}
+
+uint8_t UWBFrameDecoder::frameType() const {
+    return _frame[0];
+}
+
+const uint8_t* UWBFrameDecoder::payload() const {
+    return _frame + 1;
+}
+
+int UWBFrameDecoder::payloadLength() const {
+    return _frameLength - 1;
+}
+
+uint32_t UWBFrameDecoder::getCrcErrors() const {
+    return _crcErrors;
+}
@@ -0,0 +1,115 @@
+#ifndef UWB_STREAM_H
+#define UWB_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Binary stream framing used by the DATA_LOGGER binary output and the
+// Position Server's position stream.
+//
+// Each frame is   COBS( type | payload | crc16 ) 0x00
+// - type:    one byte, see UWBFrameType
+// - payload: little-endian record, layout depends on type
+// - crc16:   CRC-16/CCITT-FALSE over type + payload, little-endian
+// COBS removes every 0x00 from the frame so 0x00 always marks a frame end
+// and a reader can resynchronise after lost bytes.
+
+#ifndef UWB_STREAM_BUFFER_SIZE
+#define UWB_STREAM_BUFFER_SIZE 2048   // Bytes queued before frames are dropped
+#endif
+
+enum UWBFrameType {
+    FRAME_RANGE = 0x01,   // One range report (UWBRangeRecord)
+    FRAME_DROPS = 0x02,   // uint32 total frames dropped so far
+    FRAME_POSITION = 0x03 // One solved or uploaded fix (UWBPositionRecord)
+};
+
+// One parsed range report
+//   u32 timestamp | u16 tagID | u16 seq | u8 anchorID | u8 mask | u16 range[popcount(mask)]
+// Ranges are whole cm, only present for anchors whose mask bit is set.
+struct UWBRangeRecord {
+    uint32_t timestamp;   // millis() on the logging anchor
+    uint16_t tagID;
+    uint16_t seq;
+    uint8_t anchorID;     // Anchor that logged the report
+    uint8_t mask;         // Bit n set = range to anchor n present
+    uint16_t range[8];    // cm, 0 where the mask bit is clear
+};
+
+// One fix from a Position Server
+//   u32 timestamp | u16 tagID | u16 seq | i32 x | i32 y | u16 residual | u8 mask | u8 flags
+struct UWBPositionRecord {
+    uint32_t timestamp;   // millis() on the server when the ranges were taken
+    uint16_t tagID;
+    uint16_t seq;         // Module sequence number of the report (low 16 bits)
+    int32_t x, y;         // mm
+    uint16_t residual;    // RMS range error in mm (quality), 0xFFFF if unknown
+    uint8_t mask;         // Anchors in the solve, 0 for fixes the tag uploaded
+    uint8_t flags;        // POSITION_UPLOADED
+};
+
+static const uint8_t POSITION_UPLOADED = 0x01;  // Solved by the tag (uploadFixes())
+static const int POSITION_RECORD_SIZE = 20;
+
+// Record encoding (return bytes written / false on malformed input)
+int encodeRangeRecord(const UWBRangeRecord& record, uint8_t* out);
+bool decodeRangeRecord(const uint8_t* data, int length, UWBRangeRecord& record);
+int encodePositionRecord(const UWBPositionRecord& record, uint8_t* out);
+bool decodePositionRecord(const uint8_t* data, int length, UWBPositionRecord& record);
+
+uint16_t uwbCrc16(const uint8_t* data, int length);
+
+// Largest encoded frame, including COBS overhead and the delimiter
+static const int UWB_MAX_FRAME = 64;
+
+// Bounded byte ring holding complete encoded frames. Frames are queued
+// whole or not at all; when there is no room the frame is counted as
+// dropped instead of blocking the caller.
+class UWBFrameQueue {
+public:
+    static const int CAPACITY = UWB_STREAM_BUFFER_SIZE;
+
+    UWBFrameQueue();
+
+    // Encode and queue a frame
+    bool push(uint8_t type, const uint8_t* payload, int length);
+
+    // Contiguous block of bytes ready to write, and mark bytes written
+    int peek(const uint8_t** data) const;
+    void consume(int count);
+
+    int used() const;
+    uint32_t getDropped() const;
+    uint32_t getQueued() const;
+
+private:
+    uint8_t _buffer[CAPACITY];
+    int _head;       // Next byte to write out
+    int _count;      // Bytes queued
+    uint32_t _dropped;
+    uint32_t _queued;
+};
+
+// Incremental frame reader (used by host-side tools)
+class UWBFrameDecoder {
+public:
+    UWBFrameDecoder();
+
+    // Feed one byte; returns true when a valid frame is complete
+    bool feed(uint8_t byte);
+
+    uint8_t frameType() const;
+    const uint8_t* payload() const;
+    int payloadLength() const;
+    uint32_t getCrcErrors() const;
+
+private:
+    uint8_t _raw[UWB_MAX_FRAME];
+    uint8_t _frame[UWB_MAX_FRAME];
+    int _rawLength;
+    int _frameLength;
+    bool _overflow;
+    uint32_t _crcErrors;
+};
+
+#endif
@@ -0,0 +1,354 @@
+#include "UWBSurvey.h"
+#include <math.h>
+
+static const int MAX_PARAMS = 2 * UWBSurvey::MAX_ANCHORS;
+
+// Solve A x = b in place (Gaussian elimination with partial pivoting).
+// float keeps the two 16x16 matrices small on the loop task's stack.
+static bool solveLinear(float A[MAX_PARAMS][MAX_PARAMS], float* b, int n) {
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++) {
+            if (fabsf(A[row][col]) > fabsf(A[pivot][col])) pivot = row;
+        }
+        if (fabsf(A[pivot][col]) < 1e-9f) return false;
+        if (pivot != col) {
+            for (int k = 0; k < n; k++) {
+                float t = A[col][k]; A[col][k] = A[pivot][k]; A[pivot][k] = t;
+            }
+            float t = b[col]; b[col] = b[pivot]; b[pivot] = t;
+        }
+        for (int row = col + 1; row < n; row++) {
+            float f = A[row][col] / A[col][col];
+            for (int k = col; k < n; k++) A[row][k] -= f * A[col][k];
+            b[row] -= f * b[col];
+        }
+    }
+    for (int row = n - 1; row >= 0; row--) {
+        float sum = b[row];
+        for (int k = row + 1; k < n; k++) sum -= A[row][k] * b[k];
+        b[row] = sum / A[row][row];
+    }
+    return true;
+}
+
+// Eigenvalues (values) and eigenvectors (columns of vectors) of a
+// symmetric matrix, cyclic Jacobi rotations
+static void symmetricEigen(double a[UWBSurvey::MAX_ANCHORS][UWBSurvey::MAX_ANCHORS], int n,
+                           double* values, double vectors[UWBSurvey::MAX_ANCHORS][UWBSurvey::MAX_ANCHORS]) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) vectors[i][j] = (i == j) ? 1.0 : 0.0;
+    }
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double off = 0;
+        for (int p = 0; p < n; p++) {
+            for (int q = p + 1; q < n; q++) off += a[p][q] * a[p][q];
+        }
+        if (off < 1e-18) break;
+        for (int p = 0; p < n; p++) {
+            for (int q = p + 1; q < n; q++) {
+                if (fabs(a[p][q]) < 1e-300) continue;
+                double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1));
+                double c = 1 / sqrt(t * t + 1), s = t * c;
+                for (int k = 0; k < n; k++) {
+                    double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++) {
+                    double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++) {
+                    double vkp = vectors[k][p], vkq = vectors[k][q];
+                    vectors[k][p] = c * vkp - s * vkq;
+                    vectors[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) values[i] = a[i][i];
+}
+
+UWBSurvey::UWBSurvey() {
+    reset();
+}
+
+void UWBSurvey::reset() {
+    for (int a = 0; a < MAX_ANCHORS; a++) {
+        for (int b = 0; b < MAX_ANCHORS; b++) {
+            _sum[a][b] = 0.0;
+            _count[a][b] = 0;
+        }
+        _x[a] = _y[a] = 0.0;
+    }
+    _solved = 0;
+    _residual = -1.0;
+}
+
+void UWBSurvey::addRange(int a, int b, float cm) {
+    if (a < 0 || b < 0 || a >= MAX_ANCHORS || b >= MAX_ANCHORS || a == b || cm <= 0) return;
+    if (a > b) { int t = a; a = b; b = t; }
+    if (_count[a][b] == 0xFFFF) return;
+    _sum[a][b] += cm;
+    _count[a][b]++;
+}
+
+void UWBSurvey::addReport(int anchorID, const UWBRangeReport& report) {
+    if (!report.hasRanges) return;
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        if (report.mask & (1 << i)) {
+            addRange(anchorID, i, report.range[i]);
+        }
+    }
+}
+
+bool UWBSurvey::getRange(int a, int b, float& cm) const {
+    int count = getRangeCount(a, b);
+    if (count == 0) return false;
+    if (a > b) { int t = a; a = b; b = t; }
+    cm = _sum[a][b] / count;
+    return true;
+}
+
+int UWBSurvey::getRangeCount(int a, int b) const {
+    if (a < 0 || b < 0 || a >= MAX_ANCHORS || b >= MAX_ANCHORS || a == b) return 0;
+    if (a > b) { int t = a; a = b; b = t; }
+    return _count[a][b];
+}
+
+uint8_t UWBSurvey::getAnchorMask() const {
+    uint8_t mask = 0;
+    for (int a = 0; a < MAX_ANCHORS; a++) {
+        for (int b = a + 1; b < MAX_ANCHORS; b++) {
+            if (_count[a][b] > 0) mask |= (1 << a) | (1 << b);
+        }
+    }
+    return mask;
+}
+
+bool UWBSurvey::getPosition(int anchorID, float& x, float& y) const {
+    if (anchorID < 0 || anchorID >= MAX_ANCHORS || !(_solved & (1 << anchorID))) return false;
+    x = _x[anchorID];
+    y = _y[anchorID];
+    return true;
+}
+
+bool UWBSurvey::solve() {
+    _solved = 0;
+    _residual = -1.0;
+
+    int ids[MAX_ANCHORS];
+    int n = 0;
+    uint8_t mask = getAnchorMask();
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        if (mask & (1 << i)) ids[n++] = i;
+    }
+    if (n < 3) return false;
+
+    // Each anchor needs two distances and the whole layout 2n-3, or
+    // parts of it can fold over
+    int pairs = 0;
+    for (int i = 0; i < n; i++) {
+        int degree = 0;
+        for (int j = 0; j < n; j++) {
+            if (getRangeCount(ids[i], ids[j]) > 0) degree++;
+        }
+        if (degree < 2) return false;
+        pairs += degree;
+    }
+    if (pairs / 2 < 2 * n - 3) return false;
+
+    initialLayout(ids, n);
+    refineLayout(ids, n);
+    normalizeLayout(ids, n);
+    _residual = layoutResidual(ids, n, _x, _y);
+    _solved = mask;
+    return true;
+}
+
+void UWBSurvey::initialLayout(const int* ids, int n) {
+    // Distance matrix; pairs never measured get their shortest path
+    double d[MAX_ANCHORS][MAX_ANCHORS];
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            float cm;
+            if (i == j) d[i][j] = 0;
+            else if (getRange(ids[i], ids[j], cm)) d[i][j] = cm;
+            else d[i][j] = HUGE_VAL;
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                if (d[i][k] + d[k][j] < d[i][j]) d[i][j] = d[i][k] + d[k][j];
+            }
+        }
+    }
+
+    // Classical MDS: double-centred squared distances, two largest eigenpairs
+    double b[MAX_ANCHORS][MAX_ANCHORS];
+    double rowMean[MAX_ANCHORS];
+    double mean = 0;
+    for (int i = 0; i < n; i++) {
+        rowMean[i] = 0;
+        for (int j = 0; j < n; j++) rowMean[i] += d[i][j] * d[i][j];
+        rowMean[i] /= n;
+        mean += rowMean[i];
+    }
+    mean /= n;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            b[i][j] = -0.5 * (d[i][j] * d[i][j] - rowMean[i] - rowMean[j] + mean);
+        }
+    }
+
+    double values[MAX_ANCHORS] = {0};
+    double vectors[MAX_ANCHORS][MAX_ANCHORS];
+    symmetricEigen(b, n, values, vectors);
+    int first = 0, second = -1;
+    for (int i = 1; i < n; i++) {
+        if (values[i] > values[first]) first = i;
+    }
+    for (int i = 0; i < n; i++) {
+        if (i != first && (second < 0 || values[i] > values[second])) second = i;
+    }
+    double scaleX = sqrt(values[first] > 0 ? values[first] : 0);
+    double scaleY = sqrt(values[second] > 0 ? values[second] : 0);
+    for (int i = 0; i < n; i++) {
+        _x[ids[i]] = (float)(vectors[i][first] * scaleX);
+        _y[ids[i]] = (float)(vectors[i][second] * scaleY);
+    }
+}
+
+void UWBSurvey::refineLayout(const int* ids, int n) {
+    // Levenberg-Marquardt over all coordinates; the damping also pins the
+    // free translation and rotation, which normalizeLayout() fixes later
+    double px[MAX_ANCHORS], py[MAX_ANCHORS];
+    for (int i = 0; i < n; i++) {
+        px[i] = _x[ids[i]];
+        py[i] = _y[ids[i]];
+    }
+
+    double lambda = 1e-3;
+    double cost = -1;
+    for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+        float A[MAX_PARAMS][MAX_PARAMS] = {{0}};
+        float g[MAX_PARAMS] = {0};
+        double current = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                float measured;
+                if (!getRange(ids[i], ids[j], measured)) continue;
+                double dx = px[i] - px[j], dy = py[i] - py[j];
+                double dist = sqrt(dx * dx + dy * dy);
+                if (dist < 1e-6) dist = 1e-6;
+                double r = dist - measured;
+                current += r * r;
+                float jac[4] = {(float)(dx / dist), (float)(dy / dist), (float)(-dx / dist), (float)(-dy / dist)};
+                int idx[4] = {2 * i, 2 * i + 1, 2 * j, 2 * j + 1};
+                for (int a = 0; a < 4; a++) {
+                    g[idx[a]] += jac[a] * (float)r;
+                    for (int c = 0; c < 4; c++) A[idx[a]][idx[c]] += jac[a] * jac[c];
+                }
+            }
+        }
+        if (cost < 0) cost = current;
+
+        int m = 2 * n;
+        float step[MAX_PARAMS];
+        bool accepted = false;
+        while (lambda < 1e6) {
+            float M[MAX_PARAMS][MAX_PARAMS];
+            for (int a = 0; a < m; a++) {
+                for (int c = 0; c < m; c++) M[a][c] = A[a][c];
+                M[a][a] += (float)(lambda * (A[a][a] + 1.0));
+                step[a] = -g[a];
+            }
+            if (!solveLinear(M, step, m)) {
+                lambda *= 10;
+                continue;
+            }
+            double tx[MAX_ANCHORS], ty[MAX_ANCHORS];
+            for (int i = 0; i < n; i++) {
+                tx[i] = px[i] + step[2 * i];
+                ty[i] = py[i] + step[2 * i + 1];
+            }
+            double trial = 0;
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    float measured;
+                    if (!getRange(ids[i], ids[j], measured)) continue;
+                    double r = sqrt((tx[i] - tx[j]) * (tx[i] - tx[j]) + (ty[i] - ty[j]) * (ty[i] - ty[j])) - measured;
+                    trial += r * r;
+                }
+            }
+            if (trial < cost) {
+                for (int i = 0; i < n; i++) {
+                    px[i] = tx[i];
+                    py[i] = ty[i];
+                }
+                cost = trial;
+                lambda = (lambda > 1e-9) ? lambda * 0.1 : lambda;
+                accepted = true;
+                break;
+            }
+            lambda *= 10;
+        }
+        if (!accepted) break;
+
+        double largest = 0;
+        for (int a = 0; a < m; a++) {
+            if (fabsf(step[a]) > largest) largest = fabsf(step[a]);
+        }
+        if (largest < 0.01) break; // Under 0.1 mm
+    }
+
+    for (int i = 0; i < n; i++) {
+        _x[ids[i]] = (float)px[i];
+        _y[ids[i]] = (float)py[i];
+    }
+}
+
+void UWBSurvey::normalizeLayout(const int* ids, int n) {
+    // Lowest ID at the origin
+    float ox = _x[ids[0]], oy = _y[ids[0]];
+    for (int i = 0; i < n; i++) {
+        _x[ids[i]] -= ox;
+        _y[ids[i]] -= oy;
+    }
+
+    // Next anchor on the +Y axis
+    float angle = atan2f(_x[ids[1]], _y[ids[1]]);
+    float c = cosf(angle), s = sinf(angle);
+    for (int i = 0; i < n; i++) {
+        float x = _x[ids[i]], y = _y[ids[i]];
+        _x[ids[i]] = x * c - y * s;
+        _y[ids[i]] = x * s + y * c;
+    }
+
+    // Third anchor on the +X side (mirror image otherwise)
+    if (_x[ids[2]] < 0) {
+        for (int i = 0; i < n; i++) _x[ids[i]] = -_x[ids[i]];
+    }
+    _x[ids[0]] = _y[ids[0]] = 0.0;
+    _x[ids[1]] = 0.0;
+}
+
+float UWBSurvey::layoutResidual(const int* ids, int n, const float* xs, const float* ys) const {
+    double sum = 0;
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            float measured;
+            if (!getRange(ids[i], ids[j], measured)) continue;
+            float dx = xs[ids[i]] - xs[ids[j]], dy = ys[ids[i]] - ys[ids[j]];
+            double r = sqrtf(dx * dx + dy * dy) - measured;
+            sum += r * r;
+            count++;
+        }
+    }
+    return count > 0 ? (float)sqrt(sum / count) : -1.0f;
+}
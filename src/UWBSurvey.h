@@ -0,0 +1,64 @@
+#ifndef UWB_SURVEY_H
+#define UWB_SURVEY_H
+
+#include <stdint.h>
+#include "UWBSolver.h"
+#include "UWBProtocol.h"
+
+// Anchor self-survey: anchor layout from anchor-to-anchor ranges, shared
+// by the Position Server and the host-side uwb_survey tool.
+//
+// During a survey each anchor in turn runs its module as a tag with its
+// anchor number as tag ID, so its range reports hold its distances to the
+// other anchors. Ranges of a pair are averaged over both directions and
+// every report.
+//
+// solve() starts from classical multidimensional scaling (MDS) of the
+// range matrix, with pairs that were never measured estimated through
+// shortest paths, then refines the layout with Levenberg-Marquardt least
+// squares over the measured pairs. The result uses the library's layout
+// convention: the lowest anchor ID at the origin, the next on the +Y axis,
+// the third on the +X side.
+class UWBSurvey {
+public:
+    static const int MAX_ANCHORS = UWBSolver::MAX_ANCHORS;
+    static const int MAX_ITERATIONS = 50;
+
+    UWBSurvey();
+
+    void reset();
+
+    // Add one range between anchors a and b (cm); <= 0 is ignored
+    void addRange(int a, int b, float cm);
+
+    // Add a report from anchor anchorID running as a tag
+    void addReport(int anchorID, const UWBRangeReport& report);
+
+    bool getRange(int a, int b, float& cm) const;   // Mean of the pair's ranges
+    int getRangeCount(int a, int b) const;
+    uint8_t getAnchorMask() const;                  // Anchors with at least one range
+
+    // Solve the layout of every anchor in getAnchorMask(). Fails with
+    // fewer than 3 anchors, an anchor ranged to fewer than 2 others, or
+    // fewer than 2n-3 measured pairs (the layout could still fold).
+    bool solve();
+
+    uint8_t getSolvedMask() const { return _solved; }
+    bool getPosition(int anchorID, float& x, float& y) const;
+    float getResidual() const { return _residual; }  // RMS range error (cm) of the solved layout
+
+private:
+    float _sum[MAX_ANCHORS][MAX_ANCHORS];       // Used for a < b
+    uint16_t _count[MAX_ANCHORS][MAX_ANCHORS];
+    float _x[MAX_ANCHORS];
+    float _y[MAX_ANCHORS];
+    uint8_t _solved;
+    float _residual;
+
+    void initialLayout(const int* ids, int n);
+    void refineLayout(const int* ids, int n);
+    void normalizeLayout(const int* ids, int n);
+    float layoutResidual(const int* ids, int n, const float* xs, const float* ys) const;
+};
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef UWB_TAG_RECORDS_H
+#define UWB_TAG_RECORDS_H
+
+#include <stdint.h>
+#include "UWBMotion.h"
+
+// Per-tag storage used by the Position Server (TrackedTag) and by tags
+// tracking each other (OtherTag). Code always goes through the accessors
+// so the layout can be switched at build time:
+//
+//   UWB_COMPACT_TAGS 0  float coordinates/ranges and full millis() stamps (default)
+//   UWB_COMPACT_TAGS 1  16-bit IDs, fixed-point coordinates, whole cm ranges,
+//                       packed flags and 16-bit wraparound-safe time stamps
+//
+// Compact coordinates are 1/UWB_COMPACT_COORD_SCALE cm and clamp at
+// +/-163 m with the default of 2. Sites larger than that (multi-zone layouts)
+// need UWB_COMPACT_COORD_SCALE=1: +/-327 m at whole cm.
+//
+// Compact stamps count 2^UWB_COMPACT_AGE_SHIFT ms, so ages are exact to 4 ms
+// and wrap after ~262 s. Last-seen ages stay under the 5 s tag timeout; the
+// Position Server drops fixes older than UWBAnchor::MAX_FIX_AGE, so fix ages
+// stay under it too.
+
+#ifndef UWB_COMPACT_TAGS
+#define UWB_COMPACT_TAGS 0
+#endif
+
+#ifndef UWB_COMPACT_COORD_SCALE
+#define UWB_COMPACT_COORD_SCALE 2
+#endif
+
+#ifndef UWB_COMPACT_AGE_SHIFT
+#define UWB_COMPACT_AGE_SHIFT 2
+#endif
+
+#if UWB_COMPACT_TAGS
+
+inline int16_t uwbPackCoord(float cm) {
+    float q = cm * UWB_COMPACT_COORD_SCALE;
+    if (q > 32767.0f) return 32767;
+    if (q < -32767.0f) return -32767;
+    return (int16_t)(q < 0 ? q - 0.5f : q + 0.5f);
+}
+
+inline float uwbUnpackCoord(int16_t q) {
+    return q / (float)UWB_COMPACT_COORD_SCALE;
+}
+
+inline uint16_t uwbPackRange(float cm) {
+    if (cm <= 0) return 0;              // Missing
+    if (cm >= 65535.0f) return 65535;
+    uint16_t r = (uint16_t)(cm + 0.5f);
+    return (r == 0) ? 1 : r;            // Keep tiny ranges "present"
+}
+
+inline uint16_t uwbStamp(unsigned long now) {
+    return (uint16_t)(now >> UWB_COMPACT_AGE_SHIFT);
+}
+
+inline unsigned long uwbStampAge(uint16_t stamp, unsigned long now) {
+    return (unsigned long)(uint16_t)(uwbStamp(now) - stamp) << UWB_COMPACT_AGE_SHIFT;
+}
+
+// Structure for tracked tag data (used by Position Server anchor)
+struct TrackedTag {
+    int16_t tagID;
+    int16_t xq, yq;             // Fixed-point position
+    uint16_t range[8];          // Distance to each anchor (0-7), whole cm
+    int8_t rssi[8];             // Whole dBm per anchor, 0 if unknown
+    uint16_t seenStamp;
+    uint16_t fixStamp;
+    uint16_t seq;               // Low 16 bits of the module sequence number
+    uint8_t mask;               // Anchors present in the latest report
+    uint8_t flags;
+
+    static const uint8_t FLAG_ACTIVE = 0x01;
+    static const uint8_t FLAG_POSITION_VALID = 0x02;
+    static const uint8_t FLAG_FIX_UPLOADED = 0x04;
+    static const uint8_t FLAG_DIRTY = 0x08;
+
+    void reset() {
+        tagID = -1;
+        xq = yq = 0;
+        for (int i = 0; i < 8; i++) {
+            range[i] = 0;
+            rssi[i] = 0;
+        }
+        seenStamp = fixStamp = 0;
+        seq = 0;
+        mask = 0;
+        flags = 0;
+    }
+
+    int getID() const { return tagID; }
+    void setID(int id) { tagID = (int16_t)id; }
+    float getX() const { return uwbUnpackCoord(xq); }
+    float getY() const { return uwbUnpackCoord(yq); }
+    void setPosition(float x, float y) { xq = uwbPackCoord(x); yq = uwbPackCoord(y); }
+    float getDistance(int anchor) const { return range[anchor]; }
+    void setDistance(int anchor, float cm) { range[anchor] = uwbPackRange(cm); }
+    void getDistances(float* out) const { for (int i = 0; i < 8; i++) out[i] = range[i]; }
+    float getRssi(int anchor) const { return rssi[anchor]; }
+    void setRssi(int anchor, float dBm) { rssi[anchor] = (int8_t)(dBm < -127.0f ? -127 : (dBm > 0 ? 0 : (int)(dBm - 0.5f))); }
+    uint8_t getMask() const { return mask; }
+    void setMask(uint8_t m) { mask = m; }
+    uint32_t getSeq() const { return seq; }
+    void setSeq(uint32_t s) { seq = (uint16_t)s; }
+    unsigned long getAge(unsigned long now) const { return uwbStampAge(seenStamp, now); }
+    void setLastSeen(unsigned long now) { seenStamp = uwbStamp(now); }
+    unsigned long getFixAge(unsigned long now) const { return uwbStampAge(fixStamp, now); }
+    void setFixTime(unsigned long now) { fixStamp = uwbStamp(now); }
+    bool isActive() const { return flags & FLAG_ACTIVE; }
+    void setActive(bool on) { flags = on ? (flags | FLAG_ACTIVE) : (flags & ~FLAG_ACTIVE); }
+    bool isPositionValid() const { return flags & FLAG_POSITION_VALID; }
+    void setPositionValid(bool on) { flags = on ? (flags | FLAG_POSITION_VALID) : (flags & ~FLAG_POSITION_VALID); }
+    bool isFixUploaded() const { return flags & FLAG_FIX_UPLOADED; }
+    void setFixUploaded(bool on) { flags = on ? (flags | FLAG_FIX_UPLOADED) : (flags & ~FLAG_FIX_UPLOADED); }
+    bool isDirty() const { return flags & FLAG_DIRTY; }
+    void setDirty(bool on) { flags = on ? (flags | FLAG_DIRTY) : (flags & ~FLAG_DIRTY); }
+};
+
+// Other tag positions received from Position Server broadcasts (used by UWBTAG).
+// Position and velocity are fixed-point; the motion track is unpacked only
+// while a new fix is folded in or a prediction is made.
+struct OtherTag {
+    int16_t tagID;
+    uint8_t flags;
+    uint8_t shard;              // Position Server shard that reports it
+    int16_t xq, yq;             // Fixed-point position
+    int16_t vxq, vyq;           // Velocity, 0.1 cm/s
+    uint16_t stamp;             // Time of the last fix
+
+    static const uint8_t FLAG_ACTIVE = 0x01;
+    static const uint8_t FLAG_SEEN = 0x02;
+    static const uint8_t FLAG_TRACKING = 0x04;
+
+    void reset() {
+        tagID = -1;
+        flags = 0;
+        shard = 0;
+        xq = yq = vxq = vyq = 0;
+        stamp = 0;
+    }
+
+    int getID() const { return tagID; }
+    void setID(int id) { tagID = (int16_t)id; }
+    float getX() const { return uwbUnpackCoord(xq); }
+    float getY() const { return uwbUnpackCoord(yq); }
+    unsigned long getLastSeen(unsigned long now) const { return now - uwbStampAge(stamp, now); }
+
+    void loadMotion(UWBMotionFilter& motion, unsigned long now) const {
+        motion.x = getX();
+        motion.y = getY();
+        motion.vx = vxq / 10.0f;
+        motion.vy = vyq / 10.0f;
+        motion.timestamp = getLastSeen(now);
+        motion.valid = (flags & FLAG_TRACKING) != 0;
+    }
+
+    // Fold in a new fix (stores the fix itself, estimates velocity)
+    void track(float x, float y, unsigned long now, float beta) {
+        UWBMotionFilter motion;
+        loadMotion(motion, now);
+        motion.update(x, y, now, 1.0, beta);
+        xq = uwbPackCoord(motion.x);
+        yq = uwbPackCoord(motion.y);
+        vxq = packVelocity(motion.vx);
+        vyq = packVelocity(motion.vy);
+        stamp = uwbStamp(now);
+        flags |= FLAG_TRACKING;
+    }
+
+    bool predict(unsigned long atTime, unsigned long maxHorizon, float& outX, float& outY) const {
+        UWBMotionFilter motion;
+        loadMotion(motion, atTime);
+        return motion.predict(atTime, maxHorizon, outX, outY);
+    }
+
+    static int16_t packVelocity(float cmPerSecond) {
+        float q = cmPerSecond * 10.0f;
+        if (q > 32767.0f) return 32767;
+        if (q < -32767.0f) return -32767;
+        return (int16_t)q;
+    }
+
+    bool isActive() const { return flags & FLAG_ACTIVE; }
+    void setActive(bool on) { flags = on ? (flags | FLAG_ACTIVE) : (flags & ~FLAG_ACTIVE); }
+    bool isSeen() const { return flags & FLAG_SEEN; }       // Present in the latest frame from its shard
+    void setSeen(bool on) { flags = on ? (flags | FLAG_SEEN) : (flags & ~FLAG_SEEN); }
+    int getShard() const { return shard; }
+    void setShard(int s) { shard = (uint8_t)s; }
+};
+
+#else
+
+// Structure for tracked tag data (used by Position Server anchor)
+struct TrackedTag {
+    int tagID;
+    float x, y;
+    float distanceToAnchor[8];  // Distance to each anchor (0-7)
+    float rssi[8];              // dBm per anchor, 0 if unknown
+    uint32_t seq;               // Module sequence number of the latest report
+    uint8_t mask;               // Anchors present in the latest report
+    unsigned long lastSeen;
+    unsigned long fixTime;      // When x/y were measured
+    bool active;
+    bool positionValid;
+    bool fixUploaded;           // x/y came from the tag itself (FIX upload)
+    bool dirty;                 // Ranges arrived since the last solve
+
+    void reset() {
+        tagID = -1;
+        x = y = 0.0;
+        for (int i = 0; i < 8; i++) {
+            distanceToAnchor[i] = 0.0;
+            rssi[i] = 0.0;
+        }
+        seq = 0;
+        mask = 0;
+        lastSeen = fixTime = 0;
+        active = false;
+        positionValid = false;
+        fixUploaded = false;
+        dirty = false;
+    }
+
+    int getID() const { return tagID; }
+    void setID(int id) { tagID = id; }
+    float getX() const { return x; }
+    float getY() const { return y; }
+    void setPosition(float newX, float newY) { x = newX; y = newY; }
+    float getDistance(int anchor) const { return distanceToAnchor[anchor]; }
+    void setDistance(int anchor, float cm) { distanceToAnchor[anchor] = cm; }
+    void getDistances(float* out) const { for (int i = 0; i < 8; i++) out[i] = distanceToAnchor[i]; }
+    float getRssi(int anchor) const { return rssi[anchor]; }
+    void setRssi(int anchor, float dBm) { rssi[anchor] = dBm; }
+    uint8_t getMask() const { return mask; }
+    void setMask(uint8_t m) { mask = m; }
+    uint32_t getSeq() const { return seq; }
+    void setSeq(uint32_t s) { seq = s; }
+    unsigned long getAge(unsigned long now) const { return now - lastSeen; }
+    void setLastSeen(unsigned long now) { lastSeen = now; }
+    unsigned long getFixAge(unsigned long now) const { return now - fixTime; }
+    void setFixTime(unsigned long now) { fixTime = now; }
+    bool isActive() const { return active; }
+    void setActive(bool on) { active = on; }
+    bool isPositionValid() const { return positionValid; }
+    void setPositionValid(bool on) { positionValid = on; }
+    bool isFixUploaded() const { return fixUploaded; }
+    void setFixUploaded(bool on) { fixUploaded = on; }
+    bool isDirty() const { return dirty; }
+    void setDirty(bool on) { dirty = on; }
+};
+
+// Other tag positions received from Position Server broadcasts (used by UWBTAG).
+// The position lives in the motion track, which keeps the latest fix.
+struct OtherTag {
+    int tagID;
+    bool active;
+    bool seen;                  // Present in the latest frame from its shard
+    uint8_t shard;              // Position Server shard that reports it
+    UWBMotionFilter motion;     // Latest fix and velocity estimate
+
+    void reset() {
+        tagID = -1;
+        active = false;
+        seen = false;
+        shard = 0;
+        motion.reset();
+    }
+
+    int getID() const { return tagID; }
+    void setID(int id) { tagID = id; }
+    float getX() const { return motion.x; }
+    float getY() const { return motion.y; }
+    unsigned long getLastSeen(unsigned long now) const { (void)now; return motion.timestamp; }
+
+    // Fold in a new fix (stores the fix itself, estimates velocity)
+    void track(float x, float y, unsigned long now, float beta) { motion.update(x, y, now, 1.0, beta); }
+
+    bool predict(unsigned long atTime, unsigned long maxHorizon, float& outX, float& outY) const {
+        return motion.predict(atTime, maxHorizon, outX, outY);
+    }
+
+    bool isActive() const { return active; }
+    void setActive(bool on) { active = on; }
+    bool isSeen() const { return seen; }
+    void setSeen(bool on) { seen = on; }
+    int getShard() const { return shard; }
+    void setShard(int s) { shard = (uint8_t)s; }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+#include "UWBTrajectory.h"
+#include <math.h>
+
+const float UWBTrajectoryStore::MIN_HEADING_SPEED = 5.0;
+
+// Stamps hold millis() bits 2-31, so differences are taken modulo 2^30
+static const uint32_t STAMP_MASK = 0x3FFFFFFF;
+static const int32_t MAX_STEP = 1023;     // Largest |x|, |y| or time step in one delta
+
+static uint32_t packDelta(uint32_t dt, int32_t dx, int32_t dy) {
+    return (dt & 0x3FF) | (((uint32_t)dx & 0x7FF) << 10) | (((uint32_t)dy & 0x7FF) << 21);
+}
+
+static uint32_t deltaTime(uint32_t delta) { return delta & 0x3FF; }
+static int32_t deltaX(uint32_t delta) { return (int32_t)(delta << 11) >> 21; }
+static int32_t deltaY(uint32_t delta) { return (int32_t)delta >> 21; }
+
+static int32_t roundCm(float cm) {
+    return (int32_t)(cm < 0 ? cm - 0.5f : cm + 0.5f);
+}
+
+// Part i of total split into n nearly equal steps (the parts sum to total)
+static int32_t splitStep(int32_t total, int32_t i, int32_t n) {
+    return total * (i + 1) / n - total * i / n;
+}
+
+UWBTrajectoryStore::UWBTrajectoryStore(int tracks, int fixesPerTrack) {
+    if (tracks < 1) tracks = 1;
+    if (fixesPerTrack < 1) fixesPerTrack = 1;
+    if (fixesPerTrack > MAX_FIXES) fixesPerTrack = MAX_FIXES;
+    _tracks = tracks;
+    _capacity = fixesPerTrack - 1;
+    _track = new Track[_tracks];
+    _deltas = (_capacity > 0) ? new uint32_t[_tracks * _capacity] : nullptr;
+    for (int i = 0; i < _tracks; i++) {
+        clear(i);
+    }
+}
+
+UWBTrajectoryStore::~UWBTrajectoryStore() {
+    delete[] _track;
+    delete[] _deltas;
+}
+
+void UWBTrajectoryStore::clear(int track) {
+    if (track < 0 || track >= _tracks) return;
+    Track& t = _track[track];
+    t.x = t.y = 0;
+    t.stamp = 0;
+    t.vx = t.vy = 0.0;
+    t.start = 0;
+    t.count = 0;
+    t.flags = 0;
+}
+
+void UWBTrajectoryStore::add(int track, float x, float y, unsigned long timestamp) {
+    if (track < 0 || track >= _tracks) return;
+    Track& t = _track[track];
+    int32_t qx = roundCm(x);
+    int32_t qy = roundCm(y);
+    uint32_t stamp = (uint32_t)(timestamp / TIME_STEP) & STAMP_MASK;
+
+    if (!(t.flags & FLAG_FIX)) {
+        t.x = qx;
+        t.y = qy;
+        t.stamp = stamp;
+        t.flags = FLAG_FIX;
+        return;
+    }
+
+    uint32_t dt = (stamp - t.stamp) & STAMP_MASK;
+    if (dt > STAMP_MASK / 2) {
+        return; // Older than the newest fix
+    }
+    int32_t dx = qx - t.x;
+    int32_t dy = qy - t.y;
+
+    // Velocity: finite difference smoothed over VELOCITY_TIME_CONSTANT
+    unsigned long elapsed = dt * TIME_STEP;
+    if (elapsed > VELOCITY_RESET_GAP) {
+        t.flags &= ~FLAG_VELOCITY;
+        t.vx = t.vy = 0.0;
+    } else if (elapsed > 0) {
+        float vx = dx * 1000.0f / elapsed;
+        float vy = dy * 1000.0f / elapsed;
+        if (t.flags & FLAG_VELOCITY) {
+            float k = (float)elapsed / (VELOCITY_TIME_CONSTANT + elapsed);
+            t.vx += k * (vx - t.vx);
+            t.vy += k * (vy - t.vy);
+        } else {
+            t.vx = vx;
+            t.vy = vy;
+            t.flags |= FLAG_VELOCITY;
+        }
+    }
+
+    // Steps too large for one delta are split
+    int32_t steps = 1;
+    int32_t ax = dx < 0 ? -dx : dx;
+    int32_t ay = dy < 0 ? -dy : dy;
+    if ((int32_t)dt > MAX_STEP * steps) steps = ((int32_t)dt + MAX_STEP - 1) / MAX_STEP;
+    if (ax > MAX_STEP * steps) steps = (ax + MAX_STEP - 1) / MAX_STEP;
+    if (ay > MAX_STEP * steps) steps = (ay + MAX_STEP - 1) / MAX_STEP;
+
+    if (steps > _capacity) {
+        // Would flush the whole ring with filler: start over at this fix
+        uint8_t velocity = t.flags & FLAG_VELOCITY;
+        t.start = 0;
+        t.count = 0;
+        t.flags = FLAG_FIX | velocity;
+    } else {
+        for (int32_t i = 0; i < steps; i++) {
+            push(track, packDelta(splitStep((int32_t)dt, i, steps), splitStep(dx, i, steps), splitStep(dy, i, steps)));
+        }
+    }
+    t.x = qx;
+    t.y = qy;
+    t.stamp = stamp;
+}
+
+void UWBTrajectoryStore::push(int track, uint32_t delta) {
+    Track& t = _track[track];
+    if (t.count == _capacity) {
+        // Ring full: drop the oldest fix
+        t.start = (t.start + 1) % _capacity;
+        t.count--;
+    }
+    _deltas[track * _capacity + (t.start + t.count) % _capacity] = delta;
+    t.count++;
+}
+
+uint32_t UWBTrajectoryStore::deltaAt(int track, int age) const {
+    const Track& t = _track[track];
+    return _deltas[track * _capacity + (t.start + t.count - 1 - age) % _capacity];
+}
+
+int UWBTrajectoryStore::getFixCount(int track) const {
+    if (track < 0 || track >= _tracks || !(_track[track].flags & FLAG_FIX)) return 0;
+    return _track[track].count + 1;
+}
+
+bool UWBTrajectoryStore::getLatest(int track, UWBTrajectoryPoint& out) const {
+    if (getFixCount(track) == 0) return false;
+    const Track& t = _track[track];
+    out.x = t.x;
+    out.y = t.y;
+    out.timestamp = (unsigned long)t.stamp * TIME_STEP;
+    return true;
+}
+
+bool UWBTrajectoryStore::getVelocity(int track, float& vx, float& vy) const {
+    if (track < 0 || track >= _tracks || !(_track[track].flags & FLAG_VELOCITY)) return false;
+    vx = _track[track].vx;
+    vy = _track[track].vy;
+    return true;
+}
+
+float UWBTrajectoryStore::getSpeed(int track) const {
+    float vx, vy;
+    if (!getVelocity(track, vx, vy)) return 0.0;
+    return sqrtf(vx * vx + vy * vy);
+}
+
+float UWBTrajectoryStore::getHeading(int track) const {
+    float vx, vy;
+    if (!getVelocity(track, vx, vy) || sqrtf(vx * vx + vy * vy) < MIN_HEADING_SPEED) return -1.0;
+    float degrees = atan2f(vy, vx) * 57.29578f;
+    return (degrees < 0) ? degrees + 360.0f : degrees;
+}
+
+bool UWBTrajectoryStore::getPositionAt(int track, unsigned long atTime, float& x, float& y) const {
+    if (getFixCount(track) == 0) return false;
+    const Track& t = _track[track];
+
+    // How far back from the newest fix, in TIME_STEP units
+    uint32_t back = (t.stamp - (uint32_t)(atTime / TIME_STEP)) & STAMP_MASK;
+    if (back == 0 || back > STAMP_MASK / 2) {
+        x = t.x;
+        y = t.y;
+        return true;
+    }
+
+    int32_t newerX = t.x, newerY = t.y;
+    uint32_t newerBack = 0;
+    for (int i = 0; i < t.count; i++) {
+        uint32_t delta = deltaAt(track, i);
+        int32_t olderX = newerX - deltaX(delta);
+        int32_t olderY = newerY - deltaY(delta);
+        uint32_t olderBack = newerBack + deltaTime(delta);
+        if (back <= olderBack) {
+            float f = (float)(back - newerBack) / (olderBack - newerBack);
+            x = newerX + (olderX - newerX) * f;
+            y = newerY + (olderY - newerY) * f;
+            return true;
+        }
+        newerX = olderX;
+        newerY = olderY;
+        newerBack = olderBack;
+    }
+    return false; // Before the oldest fix
+}
+
+int UWBTrajectoryStore::copy(int track, UWBTrajectoryPoint* out, int maxCount) const {
+    if (maxCount <= 0 || getFixCount(track) == 0) return 0;
+    const Track& t = _track[track];
+    int32_t x = t.x, y = t.y;
+    uint32_t stamp = t.stamp;
+    int n = 0;
+    out[n].x = x;
+    out[n].y = y;
+    out[n].timestamp = (unsigned long)stamp * TIME_STEP;
+    n++;
+    for (int i = 0; i < t.count && n < maxCount; i++) {
+        uint32_t delta = deltaAt(track, i);
+        x -= deltaX(delta);
+        y -= deltaY(delta);
+        stamp = (stamp - deltaTime(delta)) & STAMP_MASK;
+        out[n].x = x;
+        out[n].y = y;
+        out[n].timestamp = (unsigned long)stamp * TIME_STEP;
+        n++;
+    }
+    return n;
+}
+
+unsigned long UWBTrajectoryStore::getMemoryBytes() const {
+    return sizeof(*this) + _tracks * (sizeof(Track) + _capacity * sizeof(uint32_t));
+}
@@ -0,0 +1,84 @@
+#ifndef UWB_TRAJECTORY_H
+#define UWB_TRAJECTORY_H
+
+#include <stdint.h>
+
+// Recent fixes of every tag in one fixed allocation, made once when
+// history is turned on. Each track keeps its newest fix in full and each
+// older fix as a 4-byte delta to the next one:
+//
+//   bits 0-9    time step, 4 ms units (up to 4.09 s)
+//   bits 10-20  x step, whole cm, signed (up to +/-10.23 m)
+//   bits 21-31  y step, whole cm, signed
+//
+// A step that does not fit is split over several deltas. A gap or jump
+// that would take more deltas than the ring holds restarts the track.
+// Once a track's ring is full its oldest fix is dropped.
+//
+// Tracks are indexed by the owner's tag table slot (like UWBLinkStats).
+// Speed and heading come from a velocity estimate updated on every fix, so
+// reading them costs nothing. Time lookups walk back from the newest fix.
+
+struct UWBTrajectoryPoint {
+    float x, y;               // cm, whole cm resolution
+    unsigned long timestamp;  // millis(), 4 ms resolution
+};
+
+class UWBTrajectoryStore {
+public:
+    // fixesPerTrack includes the newest fix (1-1024)
+    UWBTrajectoryStore(int tracks, int fixesPerTrack);
+    ~UWBTrajectoryStore();
+    UWBTrajectoryStore(const UWBTrajectoryStore&) = delete;            // Owns the rings
+    UWBTrajectoryStore& operator=(const UWBTrajectoryStore&) = delete;
+
+    // Append a fix; fixes older than the newest one are ignored
+    void add(int track, float x, float y, unsigned long timestamp);
+    void clear(int track);
+
+    int getFixCount(int track) const;
+    bool getLatest(int track, UWBTrajectoryPoint& out) const;
+    bool getVelocity(int track, float& vx, float& vy) const;    // cm/s
+    float getSpeed(int track) const;                            // cm/s, 0 if unknown
+    float getHeading(int track) const;                          // Degrees from +X toward +Y, -1 if not moving
+
+    // Position at atTime, interpolated between fixes. The newest fix for
+    // later times; false before the oldest fix.
+    bool getPositionAt(int track, unsigned long atTime, float& x, float& y) const;
+
+    // Newest fix first; returns the count
+    int copy(int track, UWBTrajectoryPoint* out, int maxCount) const;
+
+    int getTracks() const { return _tracks; }
+    int getFixesPerTrack() const { return _capacity + 1; }
+    unsigned long getMemoryBytes() const;
+
+    static const int MAX_FIXES = 1024;
+    static const unsigned long TIME_STEP = 4;               // ms per time unit
+    static const unsigned long VELOCITY_TIME_CONSTANT = 500; // ms, velocity smoothing
+    static const unsigned long VELOCITY_RESET_GAP = 2000;   // ms, restart the estimate after this
+    static const float MIN_HEADING_SPEED;                   // cm/s
+
+private:
+    struct Track {
+        int32_t x, y;         // Newest fix, whole cm
+        uint32_t stamp;       // Newest fix time in TIME_STEP units
+        float vx, vy;         // cm/s
+        uint16_t start;       // Ring index of the oldest delta
+        uint16_t count;       // Deltas stored
+        uint8_t flags;
+    };
+
+    static const uint8_t FLAG_FIX = 0x01;
+    static const uint8_t FLAG_VELOCITY = 0x02;
+
+    void push(int track, uint32_t delta);
+    uint32_t deltaAt(int track, int age) const;  // age 0 = newest delta
+
+    Track* _track;
+    uint32_t* _deltas;    // _capacity per track
+    int _tracks;
+    int _capacity;
+};
+
+#endif
@@ -0,0 +1,363 @@
+#include "UWBZones.h"
+#include <cmath> // Include for sqrt() and abs() functions
+
+UWBZoneEngine::UWBZoneEngine(int tags) {
+    _zoneCount = 0;
+    _hysteresis = 0.0;
+    _onEnter = nullptr;
+    _onExit = nullptr;
+
+    for (int i = 0; i < MAX_ZONES; i++) {
+        _zones[i].used = false;
+        _zones[i].vertexCount = 0;
+    }
+
+    _tagCount = (tags > 0) ? tags : 1;
+    _tags = new TagState[_tagCount];
+    for (int i = 0; i < _tagCount; i++) {
+        _tags[i].tagID = -1;
+        _tags[i].inside = 0;
+        _tags[i].lastX = 0.0;
+        _tags[i].lastY = 0.0;
+        _tags[i].evaluated = false;
+    }
+
+    rebuildGrid();
+}
+
+UWBZoneEngine::~UWBZoneEngine() {
+    delete[] _tags;
+}
+
+int UWBZoneEngine::addCircle(float x, float y, float radius) {
+    if (radius <= 0) return -1;
+
+    int id = allocateZone();
+    if (id < 0) return -1;
+
+    Zone& zone = _zones[id];
+    zone.shape = ZONE_CIRCLE;
+    zone.vx[0] = x;
+    zone.vy[0] = y;
+    zone.radius = radius;
+    zone.minX = x - radius;
+    zone.minY = y - radius;
+    zone.maxX = x + radius;
+    zone.maxY = y + radius;
+
+    rebuildGrid();
+    invalidateTags();
+    return id;
+}
+
+int UWBZoneEngine::addRect(float x1, float y1, float x2, float y2) {
+    int id = allocateZone();
+    if (id < 0) return -1;
+
+    Zone& zone = _zones[id];
+    zone.shape = ZONE_RECT;
+    zone.minX = (x1 < x2) ? x1 : x2;
+    zone.maxX = (x1 < x2) ? x2 : x1;
+    zone.minY = (y1 < y2) ? y1 : y2;
+    zone.maxY = (y1 < y2) ? y2 : y1;
+
+    rebuildGrid();
+    invalidateTags();
+    return id;
+}
+
+int UWBZoneEngine::addPolygon(const float* xs, const float* ys, int count) {
+    if (xs == nullptr || ys == nullptr || count < 3 || count > MAX_ZONE_VERTICES) {
+        return -1;
+    }
+
+    int id = allocateZone();
+    if (id < 0) return -1;
+
+    Zone& zone = _zones[id];
+    zone.shape = ZONE_POLYGON;
+    zone.vertexCount = count;
+    zone.minX = zone.maxX = xs[0];
+    zone.minY = zone.maxY = ys[0];
+    for (int i = 0; i < count; i++) {
+        zone.vx[i] = xs[i];
+        zone.vy[i] = ys[i];
+        if (xs[i] < zone.minX) zone.minX = xs[i];
+        if (xs[i] > zone.maxX) zone.maxX = xs[i];
+        if (ys[i] < zone.minY) zone.minY = ys[i];
+        if (ys[i] > zone.maxY) zone.maxY = ys[i];
+    }
+
+    rebuildGrid();
+    invalidateTags();
+    return id;
+}
+
+bool UWBZoneEngine::removeZone(int zoneID) {
+    if (zoneID < 0 || zoneID >= MAX_ZONES || !_zones[zoneID].used) {
+        return false;
+    }
+
+    _zones[zoneID].used = false;
+    _zoneCount--;
+
+    // Drop membership silently - the zone went away, the tag did not move
+    uint32_t keep = ~(1UL << zoneID);
+    for (int i = 0; i < _tagCount; i++) {
+        _tags[i].inside &= keep;
+    }
+
+    rebuildGrid();
+    return true;
+}
+
+void UWBZoneEngine::clear() {
+    for (int i = 0; i < MAX_ZONES; i++) {
+        _zones[i].used = false;
+    }
+    for (int i = 0; i < _tagCount; i++) {
+        _tags[i].inside = 0;
+        _tags[i].evaluated = false;
+    }
+    _zoneCount = 0;
+    rebuildGrid();
+}
+
+int UWBZoneEngine::zoneCount() const {
+    return _zoneCount;
+}
+
+void UWBZoneEngine::setHysteresis(float cm) {
+    _hysteresis = (cm > 0) ? cm : 0.0;
+}
+
+void UWBZoneEngine::onEnter(ZoneCallback callback) {
+    _onEnter = callback;
+}
+
+void UWBZoneEngine::onExit(ZoneCallback callback) {
+    _onExit = callback;
+}
+
+void UWBZoneEngine::update(int slot, int tagID, float x, float y) {
+    if (slot < 0 || slot >= _tagCount) return;
+
+    TagState& state = _tags[slot];
+    if (state.tagID != tagID) {
+        removeTag(slot);
+        state.tagID = tagID;
+    }
+
+    // Skip evaluation entirely if the tag has not moved
+    if (state.evaluated && x == state.lastX && y == state.lastY) {
+        return;
+    }
+    state.lastX = x;
+    state.lastY = y;
+    state.evaluated = true;
+
+    if (_zoneCount == 0 && state.inside == 0) {
+        return;
+    }
+
+    // Only zones bucketed under this position, plus zones we may be leaving
+    uint32_t candidates = candidatesAt(x, y) | state.inside;
+
+    while (candidates != 0) {
+        int zoneID = __builtin_ctzl(candidates);
+        candidates &= candidates - 1;
+
+        uint32_t bit = 1UL << zoneID;
+        bool wasInside = (state.inside & bit) != 0;
+
+        // Enter on the zone edge, exit only once past the hysteresis band
+        bool nowInside = contains(_zones[zoneID], x, y, wasInside ? _hysteresis : 0.0);
+
+        if (nowInside && !wasInside) {
+            state.inside |= bit;
+            if (_onEnter != nullptr) _onEnter(tagID, zoneID);
+        } else if (!nowInside && wasInside) {
+            state.inside &= ~bit;
+            if (_onExit != nullptr) _onExit(tagID, zoneID);
+        }
+    }
+}
+
+void UWBZoneEngine::removeTag(int slot) {
+    if (slot < 0 || slot >= _tagCount) return;
+
+    TagState& state = _tags[slot];
+    int tagID = state.tagID;
+    uint32_t inside = state.inside;
+    state.tagID = -1;
+    state.inside = 0;
+    state.evaluated = false;
+
+    while (inside != 0) {
+        int zoneID = __builtin_ctzl(inside);
+        inside &= inside - 1;
+        if (_onExit != nullptr) _onExit(tagID, zoneID);
+    }
+}
+
+bool UWBZoneEngine::isInside(int tagID, int zoneID) const {
+    if (zoneID < 0 || zoneID >= MAX_ZONES) {
+        return false;
+    }
+    return (getMembership(tagID) & (1UL << zoneID)) != 0;
+}
+
+uint32_t UWBZoneEngine::getMembership(int tagID) const {
+    int slot = findTag(tagID);
+    return (slot >= 0) ? _tags[slot].inside : 0;
+}
+
+int UWBZoneEngine::findTag(int tagID) const {
+    if (tagID < 0) return -1;
+    for (int i = 0; i < _tagCount; i++) {
+        if (_tags[i].tagID == tagID) return i;
+    }
+    return -1;
+}
+
+int UWBZoneEngine::allocateZone() {
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (!_zones[i].used) {
+            _zones[i].used = true;
+            _zones[i].vertexCount = 0;
+            _zones[i].radius = 0.0;
+            _zoneCount++;
+            return i;
+        }
+    }
+    return -1; // No available slots
+}
+
+void UWBZoneEngine::invalidateTags() {
+    // Force the next update of every tag to re-test, even if it is stationary
+    for (int i = 0; i < _tagCount; i++) {
+        _tags[i].evaluated = false;
+    }
+}
+
+void UWBZoneEngine::rebuildGrid() {
+    for (int gx = 0; gx < GRID_SIZE; gx++) {
+        for (int gy = 0; gy < GRID_SIZE; gy++) {
+            _grid[gx][gy] = 0;
+        }
+    }
+
+    // Grid covers the union of all zone bounding boxes
+    bool first = true;
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (!_zones[i].used) continue;
+        if (first || _zones[i].minX < minX) minX = _zones[i].minX;
+        if (first || _zones[i].minY < minY) minY = _zones[i].minY;
+        if (first || _zones[i].maxX > maxX) maxX = _zones[i].maxX;
+        if (first || _zones[i].maxY > maxY) maxY = _zones[i].maxY;
+        first = false;
+    }
+
+    _gridValid = !first;
+    if (!_gridValid) return;
+
+    _gridMinX = minX;
+    _gridMinY = minY;
+    _cellW = (maxX - minX) / GRID_SIZE;
+    _cellH = (maxY - minY) / GRID_SIZE;
+    if (_cellW <= 0) _cellW = 1.0;
+    if (_cellH <= 0) _cellH = 1.0;
+
+    // Bucket each zone into every cell its bounding box overlaps
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (!_zones[i].used) continue;
+
+        int gx0 = (int)((_zones[i].minX - _gridMinX) / _cellW);
+        int gx1 = (int)((_zones[i].maxX - _gridMinX) / _cellW);
+        int gy0 = (int)((_zones[i].minY - _gridMinY) / _cellH);
+        int gy1 = (int)((_zones[i].maxY - _gridMinY) / _cellH);
+        if (gx1 >= GRID_SIZE) gx1 = GRID_SIZE - 1;
+        if (gy1 >= GRID_SIZE) gy1 = GRID_SIZE - 1;
+
+        for (int gx = gx0; gx <= gx1; gx++) {
+            for (int gy = gy0; gy <= gy1; gy++) {
+                _grid[gx][gy] |= (1UL << i);
+            }
+        }
+    }
+}
+
+uint32_t UWBZoneEngine::candidatesAt(float x, float y) const {
+    if (!_gridValid) return 0;
+
+    float fx = (x - _gridMinX) / _cellW;
+    float fy = (y - _gridMinY) / _cellH;
+    if (fx < 0 || fy < 0 || fx > GRID_SIZE || fy > GRID_SIZE) {
+        return 0; // Outside every zone's bounding box
+    }
+
+    int gx = (int)fx;
+    int gy = (int)fy;
+    if (gx >= GRID_SIZE) gx = GRID_SIZE - 1;
+    if (gy >= GRID_SIZE) gy = GRID_SIZE - 1;
+    return _grid[gx][gy];
+}
+
+bool UWBZoneEngine::contains(const Zone& zone, float x, float y, float margin) const {
+    switch (zone.shape) {
+        case ZONE_CIRCLE: {
+            float dx = x - zone.vx[0];
+            float dy = y - zone.vy[0];
+            float r = zone.radius + margin;
+            return (dx * dx + dy * dy) <= r * r;
+        }
+        case ZONE_RECT:
+            return x >= zone.minX - margin && x <= zone.maxX + margin &&
+                   y >= zone.minY - margin && y <= zone.maxY + margin;
+        case ZONE_POLYGON:
+            if (pointInPolygon(zone, x, y)) return true;
+            if (margin <= 0) return false;
+            // Cheap reject before measuring edge distance
+            if (x < zone.minX - margin || x > zone.maxX + margin ||
+                y < zone.minY - margin || y > zone.maxY + margin) {
+                return false;
+            }
+            return distanceToPolygon(zone, x, y) <= margin;
+    }
+    return false;
+}
+
+bool UWBZoneEngine::pointInPolygon(const Zone& zone, float x, float y) {
+    // Even-odd ray casting
+    bool inside = false;
+    int n = zone.vertexCount;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        if (((zone.vy[i] > y) != (zone.vy[j] > y)) &&
+            (x < (zone.vx[j] - zone.vx[i]) * (y - zone.vy[i]) / (zone.vy[j] - zone.vy[i]) + zone.vx[i])) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+float UWBZoneEngine::distanceToPolygon(const Zone& zone, float x, float y) {
+    float best = -1.0;
+    int n = zone.vertexCount;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        float ex = zone.vx[i] - zone.vx[j];
+        float ey = zone.vy[i] - zone.vy[j];
+        float len2 = ex * ex + ey * ey;
+        float t = 0.0;
+        if (len2 > 0.000001) {
+            t = ((x - zone.vx[j]) * ex + (y - zone.vy[j]) * ey) / len2;
+            if (t < 0) t = 0;
+            if (t > 1) t = 1;
+        }
+        float dx = x - (zone.vx[j] + t * ex);
+        float dy = y - (zone.vy[j] + t * ey);
+        float d = std::sqrt(dx * dx + dy * dy);
+        if (best < 0 || d < best) best = d;
+    }
+    return best;
+}
@@ -0,0 +1,105 @@
+#ifndef UWB_ZONES_H
+#define UWB_ZONES_H
+
+#include <stdint.h>
+
+// Callback fired when a tag enters or leaves a zone
+typedef void (*ZoneCallback)(int tagID, int zoneID);
+
+// Zone shapes supported by the zone engine
+enum ZoneShape {
+    ZONE_CIRCLE,
+    ZONE_RECT,
+    ZONE_POLYGON
+};
+
+// Geofence engine shared by UWBTAG and the Position Server anchor.
+// Zones are evaluated only when a tag reports a new position, and only
+// against the zones whose grid cell the tag falls in plus the zones it is
+// already inside, so cost scales with moving tags rather than zone count.
+//
+// Tag state is indexed by the owner's tag table slot (like UWBLinkStats),
+// so any tag ID the table can hold is tracked.
+class UWBZoneEngine {
+public:
+    static const int MAX_ZONES = 32;         // Zone IDs 0-31 (one bit each)
+    static const int MAX_ZONE_VERTICES = 8;  // Polygon vertex limit
+    static const int GRID_SIZE = 8;          // Bucket index is GRID_SIZE x GRID_SIZE
+
+    explicit UWBZoneEngine(int tags);        // Tag table slots
+    ~UWBZoneEngine();
+    UWBZoneEngine(const UWBZoneEngine&) = delete;            // Owns the tag table
+    UWBZoneEngine& operator=(const UWBZoneEngine&) = delete;
+
+    int getTags() const { return _tagCount; }
+
+    // Zone management (returns zone ID, or -1 if full/invalid)
+    int addCircle(float x, float y, float radius);
+    int addRect(float x1, float y1, float x2, float y2);
+    int addPolygon(const float* xs, const float* ys, int count);
+    bool removeZone(int zoneID);
+    void clear();
+    int zoneCount() const;
+
+    // Distance (cm) a tag must move outside a zone before it exits
+    void setHysteresis(float cm);
+
+    // Callbacks
+    void onEnter(ZoneCallback callback);
+    void onExit(ZoneCallback callback);
+
+    // Evaluate a new position for the tag in a table slot (no-op if it has
+    // not moved). A different tag ID in the slot first removes the old tag.
+    void update(int slot, int tagID, float x, float y);
+
+    // Forget the tag in a slot, firing exit callbacks for every zone it was inside
+    void removeTag(int slot);
+
+    // Queries by tag ID
+    bool isInside(int tagID, int zoneID) const;
+    uint32_t getMembership(int tagID) const;
+
+private:
+    struct Zone {
+        bool used;
+        uint8_t shape;
+        uint8_t vertexCount;
+        float minX, minY, maxX, maxY;  // Bounding box
+        float radius;                  // Circle only (center in vx[0], vy[0])
+        float vx[MAX_ZONE_VERTICES];
+        float vy[MAX_ZONE_VERTICES];
+    };
+
+    struct TagState {
+        int tagID;         // -1 while the slot is unused
+        uint32_t inside;   // Bit per zone
+        float lastX, lastY;
+        bool evaluated;    // False until first update or after zones change
+    };
+
+    Zone _zones[MAX_ZONES];
+    TagState* _tags;
+    int _tagCount;
+    int _zoneCount;
+    float _hysteresis;
+
+    // Grid bucket index over the union of zone bounding boxes
+    uint32_t _grid[GRID_SIZE][GRID_SIZE];
+    float _gridMinX, _gridMinY;
+    float _cellW, _cellH;
+    bool _gridValid;
+
+    ZoneCallback _onEnter;
+    ZoneCallback _onExit;
+
+    int findTag(int tagID) const;
+    int allocateZone();
+    void rebuildGrid();
+    void invalidateTags();
+    uint32_t candidatesAt(float x, float y) const;
+    bool contains(const Zone& zone, float x, float y, float margin) const;
+    static bool pointInPolygon(const Zone& zone, float x, float y);
+    static float distanceToPolygon(const Zone& zone, float x, float y);
+};
+
+#endif